@@ -0,0 +1,234 @@
+// Benchmarks de shortest_superstring.hh (make bench).
+//
+// Micro: overlap_value, pair_of_strings_with_highest_overlap_value (o argmax
+// que substituiu all_distinct_pairs + highest_overlap_value) e
+// pop_two_elements_and_push_overlap. Macro: shortest_superstring inteiro
+// para cada n e numero de threads. Cada medida tem aquecimento e repeticoes;
+// a saida padrao recebe uma linha CSV por medida e o arquivo --csv recebe a
+// tabela de speedup/eficiencia no formato de results.csv (T_seq e a medida
+// com a primeira contagem de --threads, normalmente 1).
+
+#include "shortest_superstring.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+// ---------------------------------------------------------------------------
+// Parametros e entradas sinteticas
+// ---------------------------------------------------------------------------
+
+struct BenchmarkOptions
+{
+    Size reps = 10 ;
+    Size warmup = 2 ;
+    std::vector <Size> threads = { 1, 2, 4 } ;
+    std::vector <Size> sizes = { 100, 200, 400 } ;
+    Size length = 100 ;
+    Size seed = 42 ;
+    String csv = "results_bench.csv" ;
+} ;
+
+// leituras de um genoma aleatorio, para haver sobreposicao. A cobertura e
+// n length / genome_length: 10x a partir de length ~ 20 (o padrao e 100);
+// abaixo disso o genoma fica com 2 n + length posicoes, para sobrar janela
+// distinta, e a cobertura cai para ~length / 2. Falso se nem assim sairem n
+// leituras distintas (so ha 4^length delas)
+auto random_reads (Size n, Size length, Size seed, Set <String>& reads) -> Boolean
+{
+    std::mt19937_64 random (seed + n) ;
+    Size genome_length = std::max <Size> (2 * n + length, n * length / 10) ;
+    String genome (genome_length, 'A') ;
+    for (char& c : genome) c = "ACGT" [random () % 4] ;
+
+    // com janelas de sobra, n leituras saem bem antes de 64 n sorteios
+    for (Size draws = 0; size (reads) < n && draws < 64 * n; ++draws)
+        reads.insert (genome.substr (random () % (genome_length - length), length)) ;
+    return size (reads) == n ;
+}
+
+// ---------------------------------------------------------------------------
+// Medidas
+// ---------------------------------------------------------------------------
+
+struct Measure
+{
+    double mean ;
+    double sd ;
+    double min ;
+} ;
+
+// body () devolve os segundos que contam (a preparacao fica de fora)
+template <typename Body> auto
+measure (const BenchmarkOptions& options, Body body) -> Measure
+{
+    for (Size k = 0; k < options.warmup; ++k) body () ;
+
+    // media e desvio (Welford), como em run_tests.sh
+    double mean = 0.0, m2 = 0.0, min = std::numeric_limits <double>::max () ;
+    for (Size k = 1; k <= options.reps; ++k) {
+        double x = body () ;
+        double d = x - mean ;
+        mean += d / (double) k ;
+        m2 += d * (x - mean) ;
+        min = std::min (min, x) ;
+    }
+    double sd = options.reps > 1 ? std::sqrt (m2 / (double) (options.reps - 1)) : 0.0 ;
+    return Measure { mean, sd, min } ;
+}
+
+template <typename Body> auto
+seconds_of (Body body) -> double
+{
+    auto tstart = std::chrono::high_resolution_clock::now () ;
+    body () ;
+    auto tend = std::chrono::high_resolution_clock::now () ;
+    return std::chrono::duration <double> (tend - tstart).count () ;
+}
+
+inline auto write_measure
+        (OutStream& out, const String& benchmark, Size n, Size threads, const BenchmarkOptions& options, const Measure& m) -> void
+{
+    out << benchmark << "," << n << "," << threads << "," << options.reps << ","
+        << m.mean << "," << m.sd << "," << m.min << std::endl ;
+}
+
+// todos os pares (i, j) da entrada, uma chamada de overlap_value por par
+auto overlap_value_benchmark (const Strings& t, const BenchmarkOptions& options) -> Measure
+{
+    volatile Size sink = 0 ;
+    return measure (options, [&] {
+        return seconds_of ([&] {
+            for (StringView a : t) for (StringView b : t) sink = sink + overlap_value (a, b) ;
+        }) ;
+    }) ;
+}
+
+auto highest_overlap_value_benchmark (const Strings& t, const BenchmarkOptions& options) -> Measure
+{
+    std::vector <StringId> ids ;
+    StringArena arena = arena_from_strings (t, ids, Encoding::bytes) ;
+    return measure (options, [&] {
+        return seconds_of ([&] {
+            pair_of_strings_with_highest_overlap_value (arena, ids, Scheduler::worksharing, 0) ;
+        }) ;
+    }) ;
+}
+
+// uma fusao do melhor par; a copia do estado nao entra no tempo
+auto pop_two_elements_benchmark (const Strings& t, const BenchmarkOptions& options) -> Measure
+{
+    std::vector <StringId> ids ;
+    StringArena arena = arena_from_strings (t, ids, Encoding::bytes) ;
+    Pair <StringId, StringId> p = pair_of_strings_with_highest_overlap_value (arena, ids, Scheduler::worksharing, 0) ;
+    return measure (options, [&] {
+        StringArena a = arena ;
+        std::vector <StringId> ss = ids ;
+        return seconds_of ([&] { pop_two_elements_and_push_overlap (a, ss, p) ; }) ;
+    }) ;
+}
+
+auto shortest_superstring_benchmark (const Strings& t, const BenchmarkOptions& options) -> Measure
+{
+    return measure (options, [&] {
+        return seconds_of ([&] { shortest_superstring (t) ; }) ;
+    }) ;
+}
+
+// ---------------------------------------------------------------------------
+// Linha de comando
+// ---------------------------------------------------------------------------
+
+auto parse_sizes (const String& x, std::vector <Size>& out) -> Boolean
+{
+    std::istringstream in (x) ;
+    out.clear () ;
+    for (Size k; in >> k; ) {
+        if (k == 0) return false ;
+        out.push_back (k) ;
+    }
+    return in.eof () && ! empty (out) ;
+}
+
+auto parse_benchmark_options (int argc, char const* argv[], BenchmarkOptions& options) -> Boolean
+{
+    for (int i = 1; i < argc; ++i) {
+        String arg = argv [i] ;
+        String value = arg.find ('=') == String::npos ? "" : arg.substr (arg.find ('=') + 1) ;
+        std::vector <Size> one ;
+        if (starts_with (arg, "--reps=")) {
+            if (! parse_sizes (value, one)) return false ;
+            options.reps = one [0] ;
+        } else if (starts_with (arg, "--warmup=")) {
+            if (value != "0" && ! parse_sizes (value, one)) return false ;
+            options.warmup = value == "0" ? 0 : one [0] ;
+        } else if (starts_with (arg, "--length=")) {
+            if (! parse_sizes (value, one)) return false ;
+            options.length = one [0] ;
+        } else if (starts_with (arg, "--seed=")) {
+            if (! parse_sizes (value, one)) return false ;
+            options.seed = one [0] ;
+        } else if (starts_with (arg, "--threads=")) {
+            if (! parse_sizes (value, options.threads)) return false ;
+        } else if (starts_with (arg, "--sizes=")) {
+            if (! parse_sizes (value, options.sizes)) return false ;
+        } else if (starts_with (arg, "--csv=")) {
+            options.csv = value ;
+        } else {
+            return false ;
+        }
+    }
+    return true ;
+}
+
+auto main (int argc, char const* argv[]) -> int
+{
+    BenchmarkOptions options ;
+    if (! parse_benchmark_options (argc, argv, options)) {
+        std::cerr << "uso: " << argv [0] << " [--reps=R] [--warmup=W] [--threads=\"1 2 4\"]"
+            << " [--sizes=\"100 200 400\"] [--length=L] [--seed=S] [--csv=arquivo]" << std::endl ;
+        return 1 ;
+    }
+
+    std::ofstream table (options.csv) ;
+    if (! table) {
+        std::cerr << "erro abrindo " << options.csv << std::endl ;
+        return 1 ;
+    }
+    table << std::fixed << std::setprecision (6) ;
+    table << "input,threads,T_seq,T_seq_sd,T_omp,T_omp_sd,S_justo,Eficiência" << std::endl ;
+
+    standard_output << "benchmark,n,threads,reps,mean,sd,min" << std::endl ;
+    for (Size n : options.sizes) {
+        Set <String> reads ;
+        if (! random_reads (n, options.length, options.seed, reads)) {
+            std::cerr << "erro: o genoma nao tem " << n << " leituras distintas de tamanho " << options.length << std::endl ;
+            return 1 ;
+        }
+        Strings t = views_of (reads) ;
+        String input = "random_" + std::to_string (n) ;
+
+        // overlap_value e a fusao sao sequenciais: uma medida por n basta
+        write_measure (standard_output, "overlap_value", n, 1, options, overlap_value_benchmark (t, options)) ;
+        write_measure (standard_output, "pop_two_elements_and_push_overlap", n, 1, options, pop_two_elements_benchmark (t, options)) ;
+
+        Measure serial = { 0.0, 0.0, 0.0 } ;
+        for (Size threads : options.threads) {
+            omp_set_num_threads ((int) threads) ;
+            write_measure (standard_output, "highest_overlap_value", n, threads, options, highest_overlap_value_benchmark (t, options)) ;
+
+            Measure total = shortest_superstring_benchmark (t, options) ;
+            write_measure (standard_output, "shortest_superstring", n, threads, options, total) ;
+
+            // a primeira contagem de threads da lista e a referencia; o
+            // mais comum e comecar por 1
+            if (threads == options.threads [0]) serial = total ;
+            double speedup = serial.mean / total.mean ;
+            table << input << "," << threads << "," << serial.mean << "," << serial.sd << ","
+                << total.mean << "," << total.sd << "," << speedup << "," << speedup / (double) threads << std::endl ;
+        }
+    }
+    return 0 ;
+}
@@ -1,6 +1,7 @@
 # checker.py
 import sys
-# uso: python3 checker.py saida.txt entrada.txt
+# uso: python3 checker.py saida.txt entrada.txt [saida_gulosa.txt]
+# com a saida gulosa, compara os tamanhos (para conferir o --engine=exact)
 
 S = open(sys.argv[1]).read().splitlines()[0]
 with open(sys.argv[2]) as f:
@@ -16,3 +17,12 @@ for s in arr:
 if ok:
     print("OK: todas as strings estão contidas na saída.")
     print("len(saída) =", len(S))
+
+if len(sys.argv) > 3:
+    G = open(sys.argv[3]).read().splitlines()[0]
+    print("len(gulosa) =", len(G), " diferença =", len(G) - len(S))
+    if len(S) > len(G):
+        print("FALHOU: a saída é maior que a gulosa")
+        ok = False
+
+sys.exit(0 if ok else 1)
@@ -1,13 +1,29 @@
 #include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using String = std::string ;
+using Size   = std::size_t ;
 
 template<typename T>
 using Set = std::set <T> ;
 
+// ---------------------------------------------------------------------------
+// Modo original (sem argumentos): todas as permutacoes da string lida da
+// entrada padrao. E o que gen_inputs.sh usa.
+// ---------------------------------------------------------------------------
+
 inline auto
 read_string_from_standard_input () -> String
 {
@@ -41,8 +57,266 @@ write_strings (const Set <String>& ss) -> void
     }
 }
 
+// ---------------------------------------------------------------------------
+// Modo de leituras (--reads, --coverage, ...): leituras de tamanho fixo
+// amostradas de um genoma aleatorio ou de --reference, com erros de
+// substituicao e duplicatas. As leituras sao geradas em blocos de
+// reads_per_chunk, cada um com o seu gerador derivado de (seed, bloco), em
+// paralelo, e escritas em ordem assim que o lote de blocos fica pronto: a
+// saida depende so da semente, nao do numero de threads, e a memoria so
+// guarda um lote.
+// ---------------------------------------------------------------------------
+
+static const Size reads_per_chunk = 16384 ;
+static const Size genome_block = 1 << 20 ;
+
+struct ReadOptions
+{
+    Size reads = 0 ;
+    Size genome = 0 ;
+    Size length = 100 ;
+    double coverage = 10.0 ;
+    double error = 0.0 ;
+    double duplication = 0.0 ;
+    String alphabet = "ACGT" ;
+    String reference ;
+    String output ;
+    std::uint64_t seed = 1 ;
+    int threads = 0 ;
+} ;
+
+// splitmix64: espalha (seed, indice) em sementes independentes
+inline auto
+mix (std::uint64_t x) -> std::uint64_t
+{
+    x += 0x9E3779B97F4A7C15ull ;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull ;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull ;
+    return x ^ (x >> 31) ;
+}
+
+// xorshift64*: rapido e com a mesma sequencia em qualquer biblioteca padrao
+struct Random
+{
+    std::uint64_t state ;
+
+    Random (std::uint64_t seed, std::uint64_t stream) : state (mix (mix (seed) ^ stream) | 1) {}
+
+    auto next () -> std::uint64_t
+    {
+        state ^= state >> 12 ;
+        state ^= state << 25 ;
+        state ^= state >> 27 ;
+        return state * 0x2545F4914F6CDD1Dull ;
+    }
+
+    auto below (Size n) -> Size { return (Size) (next () % n) ; }
+    auto chance (double p) -> bool { return (double) (next () >> 11) / 9007199254740992.0 < p ; }
+} ;
+
+// FASTA (linhas com '>' ignoradas) ou texto puro; espacos sao descartados
+auto
+read_reference (const String& file, String& genome) -> bool
+{
+    std::ifstream in (file) ;
+    if (! in) return false ;
+    String line ;
+    while (std::getline (in, line)) {
+        if (! line.empty () && line [0] == '>') continue ;
+        for (char c : line) if (! std::isspace ((unsigned char) c)) genome.push_back (c) ;
+    }
+    return true ;
+}
+
+auto
+random_genome (Size length, const ReadOptions& options) -> String
+{
+    String genome (length, ' ') ;
+    std::ptrdiff_t blocks = (std::ptrdiff_t) ((length + genome_block - 1) / genome_block) ;
+    #pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t b = 0; b < blocks; ++b) {
+        Random random (options.seed, ~(std::uint64_t) b) ;
+        Size end = std::min (length, (Size) (b + 1) * genome_block) ;
+        for (Size i = (Size) b * genome_block; i < end; ++i)
+            genome [i] = options.alphabet [random.below (options.alphabet.size ())] ;
+    }
+    return genome ;
+}
+
+// leituras [first, last) do bloco chunk, uma por linha
+auto
+generate_chunk (const String& genome, const ReadOptions& options, Size chunk, Size first, Size last) -> String
+{
+    Random random (options.seed, chunk) ;
+    Size length = options.length ;
+    Size alphabet = options.alphabet.size () ;
+    String out ;
+    out.reserve ((last - first) * (length + 1)) ;
+
+    for (Size k = first; k < last; ++k) {
+        Size done = k - first ;
+        if (done > 0 && random.chance (options.duplication)) {
+            // copia de uma leitura anterior do mesmo bloco
+            Size from = random.below (done) * (length + 1) ;
+            out.append (out, from, length + 1) ;
+            continue ;
+        }
+        Size at = out.size () ;
+        out.append (genome, random.below (genome.size () - length + 1), length) ;
+        for (Size i = at; i < at + length; ++i) {
+            if (alphabet > 1 && random.chance (options.error)) {
+                // troca por outra letra do alfabeto
+                Size current = options.alphabet.find (out [i]) ;
+                Size other = random.below (alphabet - 1) ;
+                if (current != String::npos && other >= current) ++other ;
+                out [i] = options.alphabet [other] ;
+            }
+        }
+        out.push_back ('\n') ;
+    }
+    return out ;
+}
+
+auto
+write_reads (std::FILE* out, const String& genome, const ReadOptions& options) -> bool
+{
+    std::fprintf (out, "%zu\n", options.reads) ;
+    Size chunks = (options.reads + reads_per_chunk - 1) / reads_per_chunk ;
+#ifdef _OPENMP
+    Size batch = 2 * (Size) omp_get_max_threads () ;
+#else
+    Size batch = 1 ;
+#endif
+    std::vector <String> ready (batch) ;
+
+    for (Size base = 0; base < chunks; base += batch) {
+        Size count = std::min (batch, chunks - base) ;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (std::ptrdiff_t c = 0; c < (std::ptrdiff_t) count; ++c) {
+            Size chunk = base + (Size) c ;
+            Size first = chunk * reads_per_chunk ;
+            Size last = std::min (options.reads, first + reads_per_chunk) ;
+            ready [(Size) c] = generate_chunk (genome, options, chunk, first, last) ;
+        }
+        for (Size c = 0; c < count; ++c) {
+            if (std::fwrite (ready [c].data (), 1, ready [c].size (), out) != ready [c].size ()) return false ;
+        }
+    }
+    return std::fflush (out) == 0 ;
+}
+
+inline auto
+starts_with (const String& x, const String& prefix) -> bool
+{
+    return x.compare (0, prefix.size (), prefix) == 0 ;
+}
+
+inline auto
+parse_count (const String& x, Size& n) -> bool
+{
+    if (x.empty () || x.size () > 12 || x.find_first_not_of ("0123456789") != String::npos) return false ;
+    n = std::stoull (x) ;
+    return true ;
+}
+
+inline auto
+parse_rate (const String& x, double& p, double top) -> bool
+{
+    char* end = nullptr ;
+    p = std::strtod (x.c_str (), &end) ;
+    return ! x.empty () && *end == '\0' && p >= 0.0 && p <= top ;
+}
+
+auto
+parse_read_options (int argc, char const* argv[], ReadOptions& options) -> bool
+{
+    for (int i = 1; i < argc; ++i) {
+        String arg = argv [i] ;
+        String value = arg.find ('=') == String::npos ? "" : arg.substr (arg.find ('=') + 1) ;
+        Size n = 0 ;
+        bool ok = true ;
+        if (starts_with (arg, "--reads=")) ok = parse_count (value, options.reads) && options.reads > 0 ;
+        else if (starts_with (arg, "--genome=")) ok = parse_count (value, options.genome) && options.genome > 0 ;
+        else if (starts_with (arg, "--length=")) ok = parse_count (value, options.length) && options.length > 0 ;
+        else if (starts_with (arg, "--coverage=")) ok = parse_rate (value, options.coverage, 1e9) && options.coverage > 0.0 ;
+        else if (starts_with (arg, "--error=")) ok = parse_rate (value, options.error, 1.0) ;
+        else if (starts_with (arg, "--duplication=")) ok = parse_rate (value, options.duplication, 1.0) ;
+        else if (starts_with (arg, "--alphabet=")) ok = ! (options.alphabet = value).empty () ;
+        else if (starts_with (arg, "--reference=")) ok = ! (options.reference = value).empty () ;
+        else if (starts_with (arg, "--output=")) ok = ! (options.output = value).empty () ;
+        else if (starts_with (arg, "--seed=")) { ok = parse_count (value, n) ; options.seed = n ; }
+        else if (starts_with (arg, "--threads=")) { ok = parse_count (value, n) && n > 0 && n < 4096 ; options.threads = (int) n ; }
+        else ok = false ;
+        if (! ok) return false ;
+    }
+    // com genoma (--genome ou --reference) e sem --reads, a cobertura define
+    // o numero de leituras; sem genoma, leituras e cobertura definem o genoma
+    if (options.reads == 0 && options.genome == 0 && options.reference.empty ()) options.reads = 10000 ;
+    return true ;
+}
+
+inline auto
+write_usage (char const* program) -> void
+{
+    std::cerr << "uso: " << program << " < semente   (todas as permutacoes da semente)" << std::endl ;
+    std::cerr << "     " << program << " [--reads=N] [--length=L] [--coverage=C] [--genome=G | --reference=arquivo]"
+        << " [--error=p] [--duplication=p] [--alphabet=ACGT] [--seed=S] [--threads=T] [--output=arquivo]" << std::endl ;
+}
+
+auto
+generate_reads (const ReadOptions& given) -> int
+{
+    ReadOptions options = given ;
+#ifdef _OPENMP
+    if (options.threads > 0) omp_set_num_threads (options.threads) ;
+#endif
+
+    String genome ;
+    if (! options.reference.empty ()) {
+        if (! read_reference (options.reference, genome)) {
+            std::cerr << "erro lendo " << options.reference << std::endl ;
+            return 1 ;
+        }
+    } else {
+        Size length = options.genome ;
+        if (length == 0) length = (Size) ((double) options.reads * (double) options.length / options.coverage) ;
+        genome = random_genome (std::max (length, options.length), options) ;
+    }
+    if (genome.size () < options.length) {
+        std::cerr << "genoma menor que o tamanho da leitura" << std::endl ;
+        return 1 ;
+    }
+    if (options.reads == 0) {
+        options.reads = std::max <Size> (1, (Size) (options.coverage * (double) genome.size () / (double) options.length)) ;
+    }
+
+    std::FILE* out = options.output.empty () ? stdout : std::fopen (options.output.c_str (), "wb") ;
+    if (out == nullptr) {
+        std::cerr << "erro abrindo " << options.output << std::endl ;
+        return 1 ;
+    }
+    static char buffer [1 << 20] ;
+    std::setvbuf (out, buffer, _IOFBF, sizeof (buffer)) ;
+    bool written = write_reads (out, genome, options) ;
+    if (out != stdout) written = std::fclose (out) == 0 && written ;
+    if (! written) {
+        std::cerr << "erro escrevendo a saida" << std::endl ;
+        return 1 ;
+    }
+    return 0 ;
+}
+
 int main (int argc, char const* argv[])
 {
+    if (argc > 1) {
+        ReadOptions options ;
+        if (! parse_read_options (argc, argv, options)) {
+            write_usage (argv [0]) ;
+            return 1 ;
+        }
+        return generate_reads (options) ;
+    }
+
     // s = 720 for the contest
     String s = read_string_from_standard_input () ;
     Set <String> ss = all_permutations (s) ;
@@ -50,4 +324,3 @@ int main (int argc, char const* argv[])
     write_strings (ss) ;
     return 0 ;
 }
-
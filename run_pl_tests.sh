@@ -11,10 +11,22 @@ INPUTS=${INPUTS:-"inputs/*.txt inputs/*.in"}
 # Binaries
 OMP="${OMP:-./shsup_paralel}"
 OMP_SERIAL="${OMP_SERIAL:-./shsup_sequential}"
+# Prefixo para rodar o OMP, ex.: LAUNCH="mpirun -np 2" OMP=./shsup_mpi
+LAUNCH="${LAUNCH:-}"
 
 # CSV de saída
 CSV_FILE="${CSV_OUT:-results.csv}"
 
+# Conferência antes das medidas (CHECK=0 pula)
+CHECK=${CHECK:-1}
+TIES="${TIES:-old_inputs/input_70.txt}"
+# --engine=exact nas primeiras EXACT_N strings de EXACT (Held-Karp ate 20)
+EXACT="${EXACT:-old_inputs/input_70.txt}"
+EXACT_N=${EXACT_N:-16}
+# modo online: estado com as primeiras strings de ONLINE, lote com as ONLINE_B ultimas
+ONLINE="${ONLINE:-inputs/input_280.txt}"
+ONLINE_B=${ONLINE_B:-10}
+
 # ===========================
 # Utils
 # ===========================
@@ -42,9 +54,9 @@ mean_sd() {
 
 # Extrai (total, parallel, seq_frac) da 1ª linha do STDERR (tempo do OMP)
 omp_triplet_once() {
-  local infile="$1" threads="$2" bin="$3"
+  local infile="$1" threads="$2" bin="$3" launch="${4:-}"
   local line
-  line="$(( OMP_NUM_THREADS="$threads" "$bin" < "$infile" 1>/dev/null ) 2>&1 | tr -d '\r' | sed -n '1p')"
+  line="$(( OMP_NUM_THREADS="$threads" $launch "$bin" < "$infile" 1>/dev/null ) 2>&1 | tr -d '\r' | sed -n '1p')"
   awk -v L="$line" '
     BEGIN{
       gsub(",",".",L);
@@ -57,12 +69,115 @@ omp_triplet_once() {
     }'
 }
 
+# Sem strings contidas, --engine=sorted-edges tem que dar a saída do laço
+same_engines() {
+  local infile="$1" a b
+  a="$("$OMP" < "$infile" 2>/dev/null)"
+  b="$("$OMP" --engine=sorted-edges < "$infile" 2>/dev/null)"
+  if [[ "$a" != "$b" ]]; then
+    echo "ERRO: laço e sorted-edges diferem em '$infile' (${#a} x ${#b} caracteres)." >&2
+    exit 1
+  fi
+  echo "  OK: laço = sorted-edges em $infile"
+}
+
+# A saída exata tem que conter todas as strings e não ser maior que a gulosa
+exact_vs_greedy() {
+  local infile="$1" n="$2" small="$tmp_dir/exact.txt"
+  { echo "$n"; sed -n "2,$((n + 1))p" "$infile"; } > "$small"
+  "$OMP" --engine=exact < "$small" > "$tmp_dir/exact.out" 2>/dev/null
+  "$OMP" < "$small" > "$tmp_dir/greedy.out" 2>/dev/null
+  if ! python3 checker.py "$tmp_dir/exact.out" "$small" "$tmp_dir/greedy.out" | sed 's/^/  /'; then
+    echo "ERRO: checker.py reprovou --engine=exact em '$infile' (n=$n)." >&2
+    exit 1
+  fi
+}
+
+# n leituras distintas de tamanho 8 de um genoma aleatório de 3 n letras:
+# repetitivo o bastante para o guloso errar
+genome_reads() {
+  python3 - "$1" "$2" "$3" <<'EOF_PY'
+import random, sys
+seed, alphabet, n = int(sys.argv[1]), sys.argv[2], int(sys.argv[3])
+r = random.Random(seed)
+g = ''.join(r.choice(alphabet) for _ in range(3 * n))
+s = set()
+while len(s) < n:
+    p = r.randrange(len(g) - 8)
+    s.add(g[p:p + 8])
+print(n)
+print('\n'.join(sorted(s)))
+EOF_PY
+}
+
+# Acima de 20 strings o --engine=exact vai para o branch-and-bound; expect
+# diz se ele fecha dentro de budget segundos ou esgota o prazo (e avisa em
+# stderr). Nos dois casos a saída não pode ser maior que a gulosa.
+exact_branch_and_bound() {
+  local small="$1" budget="$2" expect="$3" got n
+  n="$(head -1 "$small")"
+  "$OMP" --engine=exact --exact-budget="$budget" < "$small" > "$tmp_dir/exact.out" 2> "$tmp_dir/exact.err"
+  "$OMP" < "$small" > "$tmp_dir/greedy.out" 2>/dev/null
+  if ! python3 checker.py "$tmp_dir/exact.out" "$small" "$tmp_dir/greedy.out" | sed 's/^/  /'; then
+    echo "ERRO: checker.py reprovou o branch-and-bound (n=$n)." >&2
+    exit 1
+  fi
+  got="fechou"
+  if grep -q "esgotado" "$tmp_dir/exact.err"; then got="esgotou"; fi
+  if [[ "$got" != "$expect" ]]; then
+    echo "ERRO: o branch-and-bound com n=$n e prazo de $budget s $got (esperado: $expect)." >&2
+    exit 1
+  fi
+  echo "  OK: branch-and-bound com n=$n e prazo de $budget s $got"
+}
+
+# Um lote pequeno no modo online só calcula os pares das b novas contra os F
+# fragmentos e entre si, no máximo 2 b (F + b), e não os F^2 do estado
+online_append_pairs() {
+  local infile="$1" b="$2" st="$tmp_dir/online.state" n f pairs limit
+  n="$(head -1 "$infile")"
+  rm -f "$st"
+  { echo $((n - b)); sed -n "2,$((n - b + 1))p" "$infile"; } | "$OMP" --state="$st" > /dev/null 2>&1
+  f="$(head -1 "$st")"
+  pairs="$({ echo "$b"; sed -n "$((n - b + 2)),$((n + 1))p" "$infile"; } \
+    | "$OMP" --state="$st" --profile=csv 2>&1 >/dev/null \
+    | awk -F, '$1 == "pairs" { s += $3 } END { print s + 0 }')"
+  limit=$(( 2 * b * (f + b) ))
+  if (( pairs > limit )); then
+    echo "ERRO: lote de $b sobre $f fragmentos calculou $pairs pares (limite $limit) em '$infile'." >&2
+    exit 1
+  fi
+  echo "  OK: lote de $b sobre $f fragmentos calculou $pairs pares (limite $limit, F^2 = $((f * f)))"
+}
+
+# ===========================
+# Conferência
+# ===========================
+if [[ "$CHECK" != 0 ]]; then
+  printf "\n==== Conferência ====\n"
+  tmp_dir="$(mktemp -d)"
+  trap 'rm -rf "$tmp_dir"' EXIT
+  # empates que dependem da cabeça de cada caminho
+  printf "5\nABB\nBAB\nBBA\nBCB\nCCB\n" > "$tmp_dir/ties.txt"
+  same_engines "$tmp_dir/ties.txt"
+  for f in $TIES; do same_engines "$f"; done
+  exact_vs_greedy "$EXACT" "$EXACT_N"
+  # sementes escolhidas: a primeira instância fecha em centésimos de
+  # segundo, a segunda leva minutos
+  genome_reads 4 ABC 23 > "$tmp_dir/bb.txt"
+  exact_branch_and_bound "$tmp_dir/bb.txt" 60 fechou
+  genome_reads 1 AB 23 > "$tmp_dir/bb_hard.txt"
+  exact_branch_and_bound "$tmp_dir/bb_hard.txt" 0.2 esgotou
+  online_append_pairs "$ONLINE" "$ONLINE_B"
+fi
+
 # ===========================
 # Cabeçalho + CSV
 # ===========================
 printf "\n==== Config ====\n"
 echo "REPS     = $REPS"
 echo "THREADS  = $THREADS"
+echo "LAUNCH   = ${LAUNCH:-(nenhum)}"
 echo "INPUTS   = $INPUTS"
 printf "============\n\n"
 
@@ -104,7 +219,7 @@ for in_file in "${files[@]}"; do
   for p in $THREADS; do
     omp_total_list=""
     for ((i=1;i<=REPS;i++)); do
-      triplet="$(omp_triplet_once "$in_file" "$p" "$OMP" 2>/dev/null || true)"
+      triplet="$(omp_triplet_once "$in_file" "$p" "$OMP" "$LAUNCH" 2>/dev/null || true)"
       if [[ -z "$triplet" ]]; then
         echo "ERRO: não achei 3 números no stderr do OMP (p=$p) para '$in_file'." >&2
         exit 1
@@ -0,0 +1,3828 @@
+// Biblioteca do superstring comum mais curta: leitores, kernels de
+// sobreposicao, motores (loop, incremental, sorted-edges, exact), busca local
+// e a API solve_superstring / solve_superstrings. shsup_sequential,
+// shsup_paralel, shsup_mpi e shsup_bench sao front-ends deste cabecalho.
+// Tudo e inline ou template, entao varias unidades de traducao podem
+// incluir o cabecalho; o perfil (profile ()), o estado do MPI (ranks ()) e o
+// kernel escolhido sao estaticos de funcao, um so por programa.
+
+#ifndef SHORTEST_SUPERSTRING_HH
+#define SHORTEST_SUPERSTRING_HH
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <cstdint>
+#ifdef SHSUP_MPI
+#include <mpi.h>
+#endif
+
+using ll = long long;
+using OverlapSize = std::string::size_type;
+
+// Kernel de sobreposicao escolhido em tempo de compilacao (-DOVERLAP_KERNEL=...)
+#define OVERLAP_KERNEL_SUFFIX_SET      0
+#define OVERLAP_KERNEL_PREFIX_FUNCTION 1
+#define OVERLAP_KERNEL_SIMD            2
+
+#ifndef OVERLAP_KERNEL
+#define OVERLAP_KERNEL OVERLAP_KERNEL_SIMD
+#endif
+
+#define standard_input  std::cin
+#define standard_output std::cout
+
+using Boolean = bool ;
+using Size    = std::size_t ;
+using String  = std::string ;
+
+using InStream  = std::istream ;
+using OutStream = std::ostream ;
+
+template <typename T, typename U>
+using Pair = std::pair <T, U> ;
+
+template <typename T, typename C = std::less <T>>
+using Set = std::set <T> ;
+
+template <typename T>
+using SizeType = typename T :: size_type ;
+
+// ---------------------------------------------------------------------------
+// Instrumentacao (--profile=json|csv): tempo por fase, contadores e
+// ocupacao por thread e tempo de cada iteracao do guloso. Os tempos de fase
+// sao sempre somados (um relogio por regiao); contadores, ocupacao e
+// iteracoes so com profile ().enabled, para nao pesar no laco de pares. A
+// fracao paralela do trio de stderr e a soma das regioes paralelas.
+// ---------------------------------------------------------------------------
+
+enum class Phase { input, pairs, overlaps, reduction, merge, search } ;
+
+static const Size phase_count = 6 ;
+static const char* const phase_names [phase_count] = { "input", "pairs", "overlaps", "reduction", "merge", "search" } ;
+
+// uma por thread, do tamanho de uma linha de cache
+struct ThreadCounters
+{
+    Size pairs = 0 ;          // sobreposicoes calculadas
+    Size comparisons = 0 ;    // caracteres na janela de cada uma
+    Size allocations = 0 ;    // (re)alocacoes de buffers grandes
+    double busy = 0.0 ;       // segundos com trabalho em regioes paralelas
+    double idle = 0.0 ;       // segundos esperando a barreira do fim
+    char padding [64 - 3 * sizeof (Size) - 2 * sizeof (double)] ;
+} ;
+
+struct Profile
+{
+    Boolean enabled = false ;
+    double paralel = 0.0 ;
+    double phases [phase_count] = {} ;
+    std::vector <ThreadCounters> threads ;
+    std::vector <double> iterations ;
+} ;
+
+// um objeto so para todas as unidades de traducao que incluem o cabecalho
+inline auto profile () -> Profile&
+{
+    static Profile shared ;
+    return shared ;
+}
+
+inline auto start_profile () -> void
+{
+#ifdef _OPENMP
+    profile ().threads.assign ((Size) omp_get_max_threads (), ThreadCounters ()) ;
+#else
+    profile ().threads.assign (1, ThreadCounters ()) ;
+#endif
+    profile ().enabled = true ;
+}
+
+// no modo lote as regioes internas tem uma thread so: o contador e o da
+// thread do lote que resolve a instancia
+inline auto counters () -> ThreadCounters&
+{
+#ifdef _OPENMP
+    Size slot = omp_get_level () > 0 ? (Size) omp_get_ancestor_thread_num (1) : 0 ;
+    return profile ().threads [std::min (slot, profile ().threads.size () - 1)] ;
+#else
+    return profile ().threads [0] ;
+#endif
+}
+
+// no modo lote varias instancias podem medir tempo ao mesmo tempo
+inline auto add_phase_time (Phase phase, double seconds) -> void
+{
+    double& total = profile ().phases [(Size) phase] ;
+    #pragma omp atomic
+    total += seconds ;
+}
+
+// regiao paralela dentro de uma fase que quem chama ja mede
+inline auto add_paralel_time (double seconds) -> void
+{
+    double& total = profile ().paralel ;
+    #pragma omp atomic
+    total += seconds ;
+}
+
+// regiao paralela: entra na fase e na fracao paralela
+inline auto add_paralel_time (Phase phase, double seconds) -> void
+{
+    add_phase_time (phase, seconds) ;
+    add_paralel_time (seconds) ;
+}
+
+inline auto count_work (Size pairs, Size characters) -> void
+{
+    if (! profile ().enabled) return ;
+    ThreadCounters& c = counters () ;
+    c.pairs += pairs ;
+    c.comparisons += characters ;
+}
+
+inline auto count_allocation () -> void
+{
+    if (profile ().enabled) ++counters ().allocations ;
+}
+
+// so as iteracoes do guloso de fora de uma regiao paralela
+inline auto record_iteration (double seconds) -> void
+{
+#ifdef _OPENMP
+    if (omp_in_parallel ()) return ;
+#endif
+    if (profile ().enabled) profile ().iterations.push_back (seconds) ;
+}
+
+// ocupacao de uma thread numa regiao: do inicio ate acabar a sua parte do
+// laco (omp for nowait) e trabalho, dai ate todas acabarem e espera. stop ()
+// tem uma barreira, entao toda thread da regiao precisa chamar
+class ThreadClock
+{
+public:
+    ThreadClock () : start (std::chrono::high_resolution_clock::now ()) {}
+
+    // waiting: parte do tempo ate aqui que ja foi espera (roubo sem sucesso)
+    auto stop (double waiting = 0.0) -> void
+    {
+        if (! profile ().enabled) return ;
+        auto done = std::chrono::high_resolution_clock::now () ;
+        #pragma omp barrier
+        auto released = std::chrono::high_resolution_clock::now () ;
+        ThreadCounters& c = counters () ;
+        c.busy += std::chrono::duration <double> (done - start).count () - waiting ;
+        c.idle += std::chrono::duration <double> (released - done).count () + waiting ;
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start ;
+} ;
+
+// ---------------------------------------------------------------------------
+// Opcoes de linha de comando, repassadas aos motores
+// ---------------------------------------------------------------------------
+
+enum class OverlapStage { pairwise, automaton } ;
+enum class Encoding { bytes, packed } ;
+enum class Scheduler { worksharing, stealing } ;
+enum class Reader { stream, mapped, pipelined } ;
+enum class Report { none, json, csv } ;
+
+// --tile=auto: tamanho do bloco escolhido pela L2 e pelo tamanho das strings
+static const Size auto_tile = std::numeric_limits <Size>::max () ;
+
+// --min-overlap: no modo online, so fusoes com pelo menos isso vao para o
+// estado; as mais fracas sao refeitas a cada superstring ()
+static const Size online_min_overlap = 16 ;
+
+// --exact-budget: segundos de branch-and-bound do motor exato; esgotado,
+// fica o melhor caminho achado ate ali (no minimo o do guloso)
+static const double exact_budget_seconds = 60.0 ;
+
+struct Options
+{
+    String engine = "loop" ;
+    OverlapStage overlaps = OverlapStage::pairwise ;
+    Encoding encoding = Encoding::bytes ;
+    Scheduler scheduler = Scheduler::worksharing ;
+    Reader reader = Reader::stream ;
+    Size tile = 0 ;
+    Size max_memory = 0 ;
+    Size seed = 0 ;
+    double local_search = 0.0 ;
+    double exact_budget = exact_budget_seconds ;
+    Boolean drop_contained = false ;
+    Boolean batch = false ;
+    Report report = Report::none ;
+    String state ;
+    Size min_overlap = online_min_overlap ;
+    std::vector <String> files ;
+} ;
+
+template <typename C> inline auto
+size (const C& x) -> SizeType <C> { 
+    return x.size (); 
+}
+
+template <typename C> inline auto
+at_least_two_elements_in (const C& c) -> Boolean 
+{ 
+    return size (c) > SizeType <C> (1); 
+}
+
+template <typename T> inline auto
+first_element (const Set <T>& x) -> T 
+{ 
+    return *(x.begin ()); 
+}
+
+template <typename T> inline auto
+second_element (const Set <T>& x) -> T 
+{ 
+    return *(std::next (x.begin ()));
+ }
+
+template <typename T> inline auto
+remove (Set <T>& x, const T& e) -> Set <T>& 
+{ 
+    x.erase (e);
+    return x; 
+}
+
+template <typename T> inline auto
+push (Set <T>& x, const T& e) -> Set <T>& 
+{ 
+    x.insert (e); 
+    return x; 
+}
+
+template <typename C> inline auto
+empty (const C& x) -> Boolean 
+{ 
+    return x.empty (); 
+}
+
+inline Boolean is_prefix (const String& a, const String& b)
+{
+    if (size (a) > size (b)) return false;
+    if (! (std::mismatch(a.begin(), a.end(), b.begin()).first == a.end())) return false;
+    return true;
+}
+
+inline auto suffix_from_position (const String& x, SizeType <String> i) -> String 
+{ 
+    return x.substr (i); 
+}
+
+inline auto remove_prefix (const String& x, SizeType <String> n) -> String
+{
+    if (size (x) > n) return suffix_from_position (x, n);
+    return x;
+}
+
+inline auto all_suffixes (const String& x) -> Set <String>
+{
+    Set <String> ss;
+    SizeType <String> n = size (x);
+    while (--n) { ss.insert (x.substr (n)); }
+    return ss;
+}
+
+inline auto commom_suffix_and_prefix (const String& a, const String& b) -> String
+{
+    if (empty (a) || empty (b)) return "";
+    String x = "";
+    for (const String& s : all_suffixes (a)) {
+        if (is_prefix (s, b) && size (s) > size (x)) x = s;
+    }
+    return x;
+}
+
+struct StringView
+{
+    const char* data ;
+    Size length ;
+} ;
+
+inline auto view (const String& x) -> StringView
+{
+    return StringView { x.data (), size (x) } ;
+}
+
+// conjunto de entrada: views ordenadas e sem repeticao, como o Set <String>
+using Strings = std::vector <StringView> ;
+
+inline auto views_of (const Set <String>& t) -> Strings
+{
+    Strings x ;
+    x.reserve (size (t)) ;
+    for (const String& s : t) x.push_back (view (s)) ;
+    return x ;
+}
+
+// Maior k < |a|, k <= |b|, com sufixo de a == prefixo de b.
+// Funcao de prefixo de b[0, k) casada contra os ultimos k caracteres de a:
+// O(|a| + |b|) e sem alocacao depois que o buffer da thread aquece.
+inline auto overlap_length (StringView a, StringView b) -> OverlapSize
+{
+    if (a.length == 0 || b.length == 0) return 0 ;
+    Size k = std::min (a.length - 1, b.length) ;
+    if (k == 0) return 0 ;
+
+    static thread_local std::vector <OverlapSize> failure ;
+    if (size (failure) < k) failure.resize (k) ;
+
+    failure [0] = 0 ;
+    for (Size i = 1, q = 0; i < k; ++i) {
+        while (q > 0 && b.data [i] != b.data [q]) q = failure [q - 1] ;
+        if (b.data [i] == b.data [q]) ++q ;
+        failure [i] = q ;
+    }
+
+    const char* text = a.data + (a.length - k) ;
+    Size q = 0 ;
+    for (Size i = 0; i < k; ++i) {
+        while (q > 0 && text [i] != b.data [q]) q = failure [q - 1] ;
+        if (text [i] == b.data [q]) ++q ;
+    }
+    return q ;
+}
+
+// ---------------------------------------------------------------------------
+// Kernel SIMD: as posicoes p de a com a[p] == b[0] e a[p + 1] == b[1] sao
+// filtradas 32 (AVX2) ou 64 (AVX-512) de cada vez; cada candidata, da maior
+// sobreposicao para a menor, e conferida comparando blocos inteiros. A
+// versao e escolhida em tempo de execucao; sem AVX2 cai em overlap_length.
+// ---------------------------------------------------------------------------
+
+using OverlapKernel = OverlapSize (*) (StringView, StringView) ;
+
+// cauda: candidatas que nao cabem num bloco inteiro
+inline auto overlap_length_tail (StringView a, StringView b, Size p) -> OverlapSize
+{
+    for (; p < a.length; ++p) {
+        Size length = a.length - p ;
+        if ( a.data [p] == b.data [0]
+                && (length == 1 || a.data [p + 1] == b.data [1])
+                && std::memcmp (a.data + p, b.data, length) == 0 )
+            return length ;
+    }
+    return 0 ;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__ ((target ("avx2")))
+inline auto equal_bytes_avx2 (const char* x, const char* y, Size length) -> Boolean
+{
+    for (; length >= 32; x += 32, y += 32, length -= 32) {
+        __m256i u = _mm256_loadu_si256 ((const __m256i*) x) ;
+        __m256i v = _mm256_loadu_si256 ((const __m256i*) y) ;
+        if ((unsigned) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (u, v)) != 0xFFFFFFFFu) return false ;
+    }
+    return std::memcmp (x, y, length) == 0 ;
+}
+
+__attribute__ ((target ("avx2")))
+inline auto overlap_length_avx2 (StringView a, StringView b) -> OverlapSize
+{
+    if (a.length == 0 || b.length == 0) return 0 ;
+    Size k = std::min (a.length - 1, b.length) ;
+    if (k == 0) return 0 ;
+
+    Size p = a.length - k ;
+    if (b.length > 1) {
+        const __m256i first  = _mm256_set1_epi8 (b.data [0]) ;
+        const __m256i second = _mm256_set1_epi8 (b.data [1]) ;
+        for (; p + 33 <= a.length; p += 32) {
+            __m256i x0 = _mm256_loadu_si256 ((const __m256i*) (a.data + p)) ;
+            __m256i x1 = _mm256_loadu_si256 ((const __m256i*) (a.data + p + 1)) ;
+            unsigned mask = (unsigned) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (x0, first))
+                          & (unsigned) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (x1, second)) ;
+            for (; mask != 0; mask &= mask - 1) {
+                Size q = p + (Size) __builtin_ctz (mask) ;
+                if (equal_bytes_avx2 (a.data + q, b.data, a.length - q)) return a.length - q ;
+            }
+        }
+    }
+    return overlap_length_tail (a, b, p) ;
+}
+
+__attribute__ ((target ("avx512f,avx512bw")))
+inline auto equal_bytes_avx512 (const char* x, const char* y, Size length) -> Boolean
+{
+    for (; length >= 64; x += 64, y += 64, length -= 64) {
+        __m512i u = _mm512_loadu_si512 ((const void*) x) ;
+        __m512i v = _mm512_loadu_si512 ((const void*) y) ;
+        if (_mm512_cmpneq_epi8_mask (u, v) != 0) return false ;
+    }
+    __mmask64 rest = length == 0 ? 0 : (~0ull >> (64 - length)) ;
+    __m512i u = _mm512_maskz_loadu_epi8 (rest, (const void*) x) ;
+    __m512i v = _mm512_maskz_loadu_epi8 (rest, (const void*) y) ;
+    return _mm512_mask_cmpneq_epi8_mask (rest, u, v) == 0 ;
+}
+
+__attribute__ ((target ("avx512f,avx512bw")))
+inline auto overlap_length_avx512 (StringView a, StringView b) -> OverlapSize
+{
+    if (a.length == 0 || b.length == 0) return 0 ;
+    Size k = std::min (a.length - 1, b.length) ;
+    if (k == 0) return 0 ;
+
+    Size p = a.length - k ;
+    if (b.length > 1) {
+        const __m512i first  = _mm512_set1_epi8 (b.data [0]) ;
+        const __m512i second = _mm512_set1_epi8 (b.data [1]) ;
+        for (; p + 65 <= a.length; p += 64) {
+            __m512i x0 = _mm512_loadu_si512 ((const void*) (a.data + p)) ;
+            __m512i x1 = _mm512_loadu_si512 ((const void*) (a.data + p + 1)) ;
+            __mmask64 mask = _mm512_cmpeq_epi8_mask (x0, first) & _mm512_cmpeq_epi8_mask (x1, second) ;
+            for (; mask != 0; mask &= mask - 1) {
+                Size q = p + (Size) __builtin_ctzll (mask) ;
+                if (equal_bytes_avx512 (a.data + q, b.data, a.length - q)) return a.length - q ;
+            }
+        }
+    }
+    return overlap_length_tail (a, b, p) ;
+}
+
+#endif
+
+inline auto select_overlap_kernel () -> OverlapKernel
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init () ;
+    if (__builtin_cpu_supports ("avx512bw")) return overlap_length_avx512 ;
+    if (__builtin_cpu_supports ("avx2")) return overlap_length_avx2 ;
+#endif
+    return overlap_length ;
+}
+
+// escolhido uma vez por processo, na primeira chamada
+inline auto simd_overlap_length () -> OverlapKernel
+{
+    static const OverlapKernel kernel = select_overlap_kernel () ;
+    return kernel ;
+}
+
+inline auto overlap_value (StringView s, StringView t) -> OverlapSize
+{
+#if OVERLAP_KERNEL == OVERLAP_KERNEL_SUFFIX_SET
+    return size (commom_suffix_and_prefix (String (s.data, s.length), String (t.data, t.length)));
+#elif OVERLAP_KERNEL == OVERLAP_KERNEL_SIMD
+    return simd_overlap_length () (s, t);
+#else
+    return overlap_length (s, t);
+#endif
+}
+
+inline auto overlap_value (const String& s, const String& t) -> SizeType <String>
+{
+    return overlap_value (view (s), view (t));
+}
+
+inline auto overlap (const String& s, const String& t) -> String
+{
+    return s + remove_prefix (t, overlap_value (s, t));
+}
+
+inline auto compare (StringView a, StringView b) -> int
+{
+    int c = std::memcmp (a.data, b.data, std::min (a.length, b.length)) ;
+    if (c != 0) return c ;
+    return a.length < b.length ? -1 : (a.length > b.length ? 1 : 0) ;
+}
+
+inline auto operator< (StringView a, StringView b) -> Boolean { return compare (a, b) < 0 ; }
+inline auto operator== (StringView a, StringView b) -> Boolean
+{
+    return a.length == b.length && std::memcmp (a.data, b.data, a.length) == 0 ;
+}
+
+inline auto contains (StringView x, StringView y) -> Boolean
+{
+    return y.length <= x.length
+        && std::search (x.data, x.data + x.length, y.data, y.data + y.length) != x.data + x.length ;
+}
+
+inline auto starts_with (const String& x, const String& prefix) -> Boolean
+{
+    return x.compare (0, size (prefix), prefix) == 0 ;
+}
+
+// ---------------------------------------------------------------------------
+// Codificacao compacta para alfabetos pequenos: cada simbolo vira um codigo
+// de 1 a 4 bits e a string e guardada em palavras de 64 bits, simbolo 0 nos
+// bits baixos. A sobreposicao compara blocos de ate 64 / bits simbolos com
+// deslocamentos e mascaras; uma string de 8 simbolos cabe numa palavra so.
+// ---------------------------------------------------------------------------
+
+struct SmallAlphabet
+{
+    unsigned bits = 0 ;
+    unsigned char code [256] ;
+
+    auto per_word () const -> Size { return 64 / bits ; }
+
+    // bits == 0 se o alfabeto tiver mais de 16 simbolos
+    static auto of (const Strings& t) -> SmallAlphabet
+    {
+        SmallAlphabet alphabet ;
+        Boolean seen [256] = {} ;
+        for (StringView s : t) for (Size i = 0; i < s.length; ++i) seen [(unsigned char) s.data [i]] = true ;
+        unsigned symbols = 0 ;
+        for (unsigned c = 0; c < 256; ++c) {
+            alphabet.code [c] = (unsigned char) symbols ;
+            if (seen [c]) ++symbols ;
+        }
+        if (symbols > 16) return alphabet ;
+        alphabet.bits = symbols <= 2 ? 1 : (symbols <= 4 ? 2 : (symbols <= 8 ? 3 : 4)) ;
+        return alphabet ;
+    }
+} ;
+
+// simbolos [start, start + count) de uma string empacotada, count <= per_word
+inline auto packed_symbols
+        (const std::uint64_t* words, Size per_word, unsigned bits, Size start, Size count) -> std::uint64_t
+{
+    Size w = start / per_word ;
+    Size offset = start % per_word ;
+    std::uint64_t x = words [w] >> (offset * bits) ;
+    if (offset + count > per_word) x |= words [w + 1] << ((per_word - offset) * bits) ;
+    return count * bits >= 64 ? x : x & ((std::uint64_t (1) << (count * bits)) - 1) ;
+}
+
+inline auto packed_overlap_length
+        ( const std::uint64_t* a, Size a_length
+        , const std::uint64_t* b, Size b_length
+        , Size per_word, unsigned bits ) -> OverlapSize
+{
+    if (a_length == 0 || b_length == 0) return 0 ;
+    Size k = std::min (a_length - 1, b_length) ;
+
+    // a e b numa palavra so: cada candidato e um deslocamento e uma mascara
+    if (a_length <= per_word && b_length <= per_word) {
+        for (; k > 0; --k) {
+            std::uint64_t suffix = a [0] >> ((a_length - k) * bits) ;
+            if (suffix == (b [0] & ((std::uint64_t (1) << (k * bits)) - 1))) return k ;
+        }
+        return 0 ;
+    }
+
+    for (; k > 0; --k) {
+        Boolean equal = true ;
+        for (Size c = 0; c < k && equal; c += per_word) {
+            Size count = std::min (per_word, k - c) ;
+            equal = packed_symbols (a, per_word, bits, a_length - k + c, count)
+                 == packed_symbols (b, per_word, bits, c, count) ;
+        }
+        if (equal) return k ;
+    }
+    return 0 ;
+}
+
+// ---------------------------------------------------------------------------
+// Arena de strings: todas as strings (entradas e fusoes) ficam num unico
+// buffer e sao referidas por um id de 32 bits. Strings mortas so ocupam
+// espaco ate a proxima compactacao. Com um alfabeto pequeno, cada string
+// tambem e guardada empacotada e overlap () usa so as palavras.
+// ---------------------------------------------------------------------------
+
+using StringId = std::uint32_t ;
+
+struct StringArena
+{
+    std::vector <char> bytes ;
+    std::vector <Size> offsets ;
+    std::vector <std::uint32_t> lengths ;
+    Size dead_bytes = 0 ;
+
+    SmallAlphabet alphabet ;
+    std::vector <std::uint64_t> words ;
+    std::vector <Size> word_offsets ;
+
+    auto operator[] (StringId id) const -> StringView
+    {
+        return StringView { bytes.data () + offsets [id], lengths [id] } ;
+    }
+
+    auto packed () const -> Boolean { return alphabet.bits != 0 ; }
+
+    auto overlap (StringId a, StringId b) const -> OverlapSize
+    {
+        count_work (1, std::min <Size> (lengths [a] - (lengths [a] > 0), lengths [b])) ;
+        return packed () ? packed_overlap (a, b) : overlap_value ((*this) [a], (*this) [b]) ;
+    }
+
+    // so com packed ()
+    auto packed_overlap (StringId a, StringId b) const -> OverlapSize
+    {
+        return packed_overlap_length
+            ( words.data () + word_offsets [a], lengths [a]
+            , words.data () + word_offsets [b], lengths [b]
+            , alphabet.per_word (), alphabet.bits ) ;
+    }
+
+    auto enable_packing (const SmallAlphabet& small) -> void
+    {
+        alphabet = small ;
+        if (! packed ()) return ;
+        for (StringId id = 0; id < (StringId) size (offsets); ++id) pack (id) ;
+    }
+
+    auto add (StringView x) -> StringId
+    {
+        StringId id = (StringId) size (offsets) ;
+        reserve_more (x.length) ;
+        offsets.push_back (size (bytes)) ;
+        lengths.push_back ((std::uint32_t) x.length) ;
+        bytes.insert (bytes.end (), x.data, x.data + x.length) ;
+        if (packed ()) pack (id) ;
+        return id ;
+    }
+
+    // s + remove_prefix (t, k), escrito direto no fim do buffer
+    auto merge (StringId s, StringId t, OverlapSize k) -> StringId
+    {
+        Size skip = lengths [t] > k ? k : 0 ;
+        Size length = lengths [s] + lengths [t] - skip ;
+        reserve_more (length) ;
+
+        StringId id = (StringId) size (offsets) ;
+        Size at = size (bytes) ;
+        offsets.push_back (at) ;
+        lengths.push_back ((std::uint32_t) length) ;
+        bytes.resize (at + length) ;
+        std::copy (bytes.data () + offsets [s], bytes.data () + offsets [s] + lengths [s], bytes.data () + at) ;
+        std::copy
+            ( bytes.data () + offsets [t] + skip
+            , bytes.data () + offsets [t] + lengths [t]
+            , bytes.data () + at + lengths [s] ) ;
+        if (packed ()) pack (id) ;
+        return id ;
+    }
+
+    auto release (StringId id) -> void { dead_bytes += lengths [id] ; }
+
+    auto needs_compaction () const -> Boolean
+    {
+        return dead_bytes >= (1u << 20) && 2 * dead_bytes >= size (bytes) ;
+    }
+
+    // mantem so os ids vivos; os outros ids deixam de ser validos
+    auto compact (const std::vector <StringId>& live) -> void
+    {
+        std::vector <char> packed ;
+        packed.reserve (size (bytes) - dead_bytes) ;
+        count_allocation () ;
+        for (StringId id : live) {
+            Size at = size (packed) ;
+            packed.insert (packed.end (), bytes.begin () + offsets [id], bytes.begin () + offsets [id] + lengths [id]) ;
+            offsets [id] = at ;
+        }
+        bytes.swap (packed) ;
+        dead_bytes = 0 ;
+
+        if (! this->packed ()) return ;
+        std::vector <std::uint64_t> kept ;
+        for (StringId id : live) {
+            Size at = size (kept) ;
+            Size n = word_count (lengths [id]) ;
+            kept.insert (kept.end (), words.begin () + word_offsets [id], words.begin () + word_offsets [id] + n) ;
+            word_offsets [id] = at ;
+        }
+        words.swap (kept) ;
+    }
+
+private:
+    auto word_count (Size length) const -> Size
+    {
+        return (length + alphabet.per_word () - 1) / alphabet.per_word () + 1 ;
+    }
+
+    // uma palavra extra no fim deixa packed_symbols ler words [w + 1]
+    auto pack (StringId id) -> void
+    {
+        if (size (word_offsets) <= id) word_offsets.resize (id + 1) ;
+        word_offsets [id] = size (words) ;
+        Size per_word = alphabet.per_word () ;
+        words.resize (size (words) + word_count (lengths [id]), 0) ;
+        std::uint64_t* w = words.data () + word_offsets [id] ;
+        const char* x = bytes.data () + offsets [id] ;
+        for (Size i = 0; i < lengths [id]; ++i)
+            w [i / per_word] |= std::uint64_t (alphabet.code [(unsigned char) x [i]]) << ((i % per_word) * alphabet.bits) ;
+    }
+
+    auto reserve_more (Size length) -> void
+    {
+        if (size (bytes) + length <= bytes.capacity ()) return ;
+        bytes.reserve (std::max (size (bytes) + length, 2 * bytes.capacity ())) ;
+        count_allocation () ;
+    }
+} ;
+
+inline auto to_string (StringView x) -> String
+{
+    return String (x.data, x.length) ;
+}
+
+inline auto lower_bound_by_content (const StringArena& arena, const std::vector <StringId>& ss, StringView x)
+    -> std::vector <StringId>::const_iterator
+{
+    return std::lower_bound
+        ( ss.begin (), ss.end (), x
+        , [&arena] (StringId id, StringView y) { return arena [id] < y ; } ) ;
+}
+
+// os ids vivos ficam ordenados pelo conteudo, como o Set <String> original
+inline auto remove (const StringArena& arena, std::vector <StringId>& ss, StringId e) -> std::vector <StringId>&
+{
+    auto it = lower_bound_by_content (arena, ss, arena [e]) ;
+    ss.erase (it) ;
+    return ss ;
+}
+
+inline auto push (StringArena& arena, std::vector <StringId>& ss, StringId e) -> std::vector <StringId>&
+{
+    auto it = lower_bound_by_content (arena, ss, arena [e]) ;
+    if (it != ss.end () && arena [*it] == arena [e]) arena.release (e) ;
+    else ss.insert (it, e) ;
+    return ss ;
+}
+
+// k = ov (p.first, p.second), ja calculada por quem chama
+inline auto pop_two_elements_and_push_overlap
+        (StringArena& arena, std::vector <StringId>& ss, const Pair <StringId, StringId>& p, OverlapSize k) -> std::vector <StringId>&
+{
+    StringId merged = arena.merge (p.first, p.second, k);
+    ss = remove (arena, ss, p.first);
+    ss = remove (arena, ss, p.second);
+    ss = push   (arena, ss, merged);
+    arena.release (p.first);
+    arena.release (p.second);
+    if (arena.needs_compaction ()) arena.compact (ss);
+    return ss;
+}
+
+inline auto pop_two_elements_and_push_overlap
+        (StringArena& arena, std::vector <StringId>& ss, const Pair <StringId, StringId>& p) -> std::vector <StringId>&
+{
+    return pop_two_elements_and_push_overlap (arena, ss, p, arena.overlap (p.first, p.second));
+}
+
+// ---------------------------------------------------------------------------
+// Escalonador com roubo de trabalho: o espaco de pares (linhas x colunas) e
+// dividido em blocos (Tile). Cada thread tem um deque; pega blocos do fim
+// do seu e, sem trabalho, rouba do inicio do deque de outra thread. Um
+// bloco e partido ao meio enquanto o custo estimado (ns por par, medido nos
+// blocos anteriores da thread) passar de tile_target_ns; a metade que sobra
+// fica no deque para quem quiser roubar.
+// ---------------------------------------------------------------------------
+
+struct Tile
+{
+    ll row_begin ;
+    ll row_end ;
+    ll column_begin ;
+    ll column_end ;
+
+    auto cells () const -> ll { return (row_end - row_begin) * (column_end - column_begin) ; }
+} ;
+
+class TileDeque
+{
+public:
+    auto push (const Tile& t) -> void
+    {
+        std::lock_guard <std::mutex> lock (mutex) ;
+        tiles.push_back (t) ;
+    }
+
+    auto pop (Tile& t) -> Boolean
+    {
+        std::lock_guard <std::mutex> lock (mutex) ;
+        if (tiles.empty ()) return false ;
+        t = tiles.back () ;
+        tiles.pop_back () ;
+        return true ;
+    }
+
+    auto steal (Tile& t) -> Boolean
+    {
+        std::lock_guard <std::mutex> lock (mutex) ;
+        if (tiles.empty ()) return false ;
+        t = tiles.front () ;
+        tiles.pop_front () ;
+        return true ;
+    }
+
+private:
+    std::mutex mutex ;
+    std::deque <Tile> tiles ;
+} ;
+
+static const double tile_target_ns = 50000.0 ;
+static const ll first_tile_cells = 1024 ;
+
+inline auto split_tile (Tile& t) -> Tile
+{
+    Tile rest = t ;
+    if (t.row_end - t.row_begin >= t.column_end - t.column_begin) {
+        ll middle = t.row_begin + (t.row_end - t.row_begin) / 2 ;
+        t.row_end = middle ;
+        rest.row_begin = middle ;
+    } else {
+        ll middle = t.column_begin + (t.column_end - t.column_begin) / 2 ;
+        t.column_end = middle ;
+        rest.column_begin = middle ;
+    }
+    return rest ;
+}
+
+// dentro de uma regiao paralela (modo lote) cada chamada usa uma thread so
+inline auto thread_count () -> Size
+{
+#ifdef _OPENMP
+    return omp_in_parallel () ? 1 : (Size) omp_get_max_threads () ;
+#else
+    return 1 ;
+#endif
+}
+
+inline auto thread_number () -> Size
+{
+#ifdef _OPENMP
+    return (Size) omp_get_thread_num () ;
+#else
+    return 0 ;
+#endif
+}
+
+// ordena blocos em paralelo e intercala os blocos aos pares
+template <typename T, typename Compare> auto
+parallel_sort (std::vector <T>& v, Compare before) -> void
+{
+    Size threads = thread_count () ;
+    Size chunks = std::max <Size> (1, std::min (threads, size (v) / 4096 + 1)) ;
+    std::vector <Size> bounds (chunks + 1) ;
+    for (Size c = 0; c <= chunks; ++c) bounds [c] = size (v) * c / chunks ;
+
+    #pragma omp parallel for schedule(static)
+    for (ll c = 0; c < (ll) chunks; ++c)
+        std::sort (v.begin () + bounds [(Size) c], v.begin () + bounds [(Size) c + 1], before) ;
+
+    for (Size width = 1; width < chunks; width *= 2) {
+        #pragma omp parallel for schedule(static)
+        for (ll c = 0; c < (ll) chunks; c += 2 * (ll) width) {
+            Size middle = (Size) c + width ;
+            if (middle >= chunks) continue ;
+            Size last = std::min (chunks, middle + width) ;
+            std::inplace_merge
+                ( v.begin () + bounds [(Size) c]
+                , v.begin () + bounds [middle]
+                , v.begin () + bounds [last]
+                , before ) ;
+        }
+    }
+}
+
+// body (tile, thread) e chamado uma vez por bloco, cobrindo rows x columns
+template <typename Body> auto
+for_each_tile_stealing (ll rows, ll columns, Body body) -> void
+{
+    if (rows <= 0 || columns <= 0) return ;
+    Size threads = thread_count () ;
+    std::vector <TileDeque> deques (threads) ;
+    for (Size k = 0; k < threads; ++k) {
+        ll begin = rows * (ll) k / (ll) threads ;
+        ll end   = rows * (ll) (k + 1) / (ll) threads ;
+        if (begin < end) deques [k].push (Tile { begin, end, 0, columns }) ;
+    }
+    std::atomic <ll> remaining (rows * columns) ;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        ThreadClock clock ;
+        Size me = thread_number () ;
+        double ns_per_cell = 0.0 ;
+        double waiting = 0.0 ;
+        unsigned victim = (unsigned) me ;
+        Tile t ;
+
+        while (remaining.load (std::memory_order_acquire) > 0) {
+            if (! deques [me].pop (t)) {
+                victim = victim * 1103515245u + 12345u ;
+                if (threads < 2 || ! deques [(victim >> 8) % threads].steal (t)) {
+                    auto tstart = std::chrono::high_resolution_clock::now () ;
+                    std::this_thread::yield () ;
+                    waiting += std::chrono::duration <double> (std::chrono::high_resolution_clock::now () - tstart).count () ;
+                    continue ;
+                }
+            }
+
+            while (t.cells () > 1
+                    && ( ns_per_cell == 0.0
+                        ? t.cells () > first_tile_cells
+                        : ns_per_cell * (double) t.cells () > tile_target_ns ))
+                deques [me].push (split_tile (t)) ;
+
+            auto tstart = std::chrono::high_resolution_clock::now () ;
+            body (t, me) ;
+            auto tend = std::chrono::high_resolution_clock::now () ;
+            double ns = std::chrono::duration <double, std::nano> (tend - tstart).count () / (double) t.cells () ;
+            ns_per_cell = ns_per_cell == 0.0 ? ns : 0.5 * (ns_per_cell + ns) ;
+
+            remaining.fetch_sub (t.cells (), std::memory_order_acq_rel) ;
+        }
+        clock.stop (waiting) ;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Blocos para a cache: o espaco (i, j) e percorrido em blocos de B linhas por
+// B colunas. As 2B strings de um bloco ficam na L2 enquanto as B^2
+// sobreposicoes dele sao calculadas, em vez de cada string de coluna passar
+// pela cache uma vez por linha. tile = 0 mantem o percurso linha a linha.
+// ---------------------------------------------------------------------------
+
+inline auto level2_cache_bytes () -> Size
+{
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long bytes = sysconf (_SC_LEVEL2_CACHE_SIZE) ;
+    if (bytes > 0) return (Size) bytes ;
+#endif
+    return 256 * 1024 ;
+}
+
+// com auto_tile, dois blocos de strings de tamanho medio ocupam metade da L2
+inline auto tile_size_for (Size requested, Size strings, Size bytes) -> Size
+{
+    if (requested != auto_tile) return requested ;
+    Size average = std::max <Size> (1, bytes / std::max <Size> (1, strings)) ;
+    return std::max <Size> (16, level2_cache_bytes () / (4 * average)) ;
+}
+
+// percorre t em sub-blocos de b x b; b = 0 percorre t linha a linha
+template <typename Cell> inline auto
+for_each_cell_blocked (const Tile& t, Size b, Cell cell) -> void
+{
+    ll step = b == 0 ? std::max (t.row_end - t.row_begin, t.column_end - t.column_begin) : (ll) b ;
+    for (ll ib = t.row_begin; ib < t.row_end; ib += step)
+        for (ll jb = t.column_begin; jb < t.column_end; jb += step)
+            for (ll i = ib; i < std::min (ib + step, t.row_end); ++i)
+                for (ll j = jb; j < std::min (jb + step, t.column_end); ++j)
+                    cell (i, j) ;
+}
+
+// ---------------------------------------------------------------------------
+// Argmax sem vetor de pares: o laco percorre o triangulo i < j e avalia
+// (i, j) e (j, i) direto. i e j sao posicoes no vetor ordenado de ids, entao
+// o desempate lexicografico do par de strings e so comparar (i, j).
+// ---------------------------------------------------------------------------
+
+struct Candidate
+{
+    OverlapSize value ;
+    ll i ;
+    ll j ;
+} ;
+
+inline auto no_candidate () -> Candidate
+{
+    return Candidate { 0, std::numeric_limits <ll>::max (), std::numeric_limits <ll>::max () } ;
+}
+
+inline auto best_of (const Candidate& a, const Candidate& b) -> Candidate
+{
+    if (a.value != b.value) return a.value > b.value ? a : b ;
+    if (a.i != b.i) return a.i < b.i ? a : b ;
+    return a.j < b.j ? a : b ;
+}
+
+#pragma omp declare reduction (best_candidate : Candidate : omp_out = best_of (omp_out, omp_in)) \
+    initializer (omp_priv = no_candidate ())
+
+// ---------------------------------------------------------------------------
+// Processos MPI (make shsup_mpi): todos leem a mesma entrada e repetem as
+// mesmas fusoes; a cada iteracao cada processo avalia so as suas linhas do
+// espaco de pares (com OpenMP dentro dele) e um MPI_Allreduce com
+// best_of escolhe o par. Como o resultado e o mesmo em todos, cada um
+// aplica a fusao por conta propria, o que equivale a difundi-la. Dentro de
+// uma regiao paralela (modo lote) nao ha divisao: MPI so e chamado pela
+// thread principal.
+// ---------------------------------------------------------------------------
+
+#ifdef SHSUP_MPI
+struct Ranks
+{
+    int rank = 0 ;
+    int count = 1 ;
+    MPI_Datatype candidate ;
+    MPI_Op best_candidate ;
+} ;
+
+// compartilhado entre as unidades de traducao, como profile ()
+inline auto ranks () -> Ranks&
+{
+    static Ranks shared ;
+    return shared ;
+}
+
+inline auto reduce_best_candidate (void* in, void* inout, int* count, MPI_Datatype*) -> void
+{
+    const Candidate* a = (const Candidate*) in ;
+    Candidate* b = (Candidate*) inout ;
+    for (int k = 0; k < *count; ++k) b [k] = best_of (a [k], b [k]) ;
+}
+#endif
+
+inline auto start_ranks () -> void
+{
+#ifdef SHSUP_MPI
+    int provided ;
+    MPI_Init_thread (nullptr, nullptr, MPI_THREAD_FUNNELED, &provided) ;
+    MPI_Comm_rank (MPI_COMM_WORLD, &ranks ().rank) ;
+    MPI_Comm_size (MPI_COMM_WORLD, &ranks ().count) ;
+    static_assert (sizeof (Candidate) == 3 * sizeof (long long), "Candidate vai como 3 long long") ;
+    MPI_Type_contiguous (3, MPI_LONG_LONG, &ranks ().candidate) ;
+    MPI_Type_commit (&ranks ().candidate) ;
+    MPI_Op_create (reduce_best_candidate, 1, &ranks ().best_candidate) ;
+#endif
+}
+
+inline auto stop_ranks () -> void
+{
+#ifdef SHSUP_MPI
+    MPI_Op_free (&ranks ().best_candidate) ;
+    MPI_Type_free (&ranks ().candidate) ;
+    MPI_Finalize () ;
+#endif
+}
+
+// so o processo 0 escreve a saida
+inline auto is_root_rank () -> Boolean
+{
+#ifdef SHSUP_MPI
+    return ranks ().rank == 0 ;
+#else
+    return true ;
+#endif
+}
+
+// este processo avalia as linhas rank_number (), rank_number () + rank_count (), ...
+inline auto rank_count () -> ll
+{
+#ifdef SHSUP_MPI
+    return omp_in_parallel () ? 1 : (ll) ranks ().count ;
+#else
+    return 1 ;
+#endif
+}
+
+inline auto rank_number () -> ll
+{
+#ifdef SHSUP_MPI
+    return omp_in_parallel () ? 0 : (ll) ranks ().rank ;
+#else
+    return 0 ;
+#endif
+}
+
+inline auto best_over_ranks (Candidate c) -> Candidate
+{
+#ifdef SHSUP_MPI
+    if (rank_count () > 1) MPI_Allreduce (MPI_IN_PLACE, &c, 1, ranks ().candidate, ranks ().best_candidate, MPI_COMM_WORLD) ;
+#endif
+    return c ;
+}
+
+template <typename Overlap>
+inline auto highest_overlap_value(const std::vector<StringId>& v, Overlap overlap) -> Pair<StringId,StringId> {
+    ll size = v.size();
+    Candidate best = no_candidate();
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    ll first = rank_number ();
+    ll step = rank_count ();
+
+    #pragma omp parallel reduction(best_candidate : best)
+    {
+        ThreadClock clock;
+        #pragma omp for schedule(dynamic) nowait
+        for (ll i = first; i < size; i += step) {
+            for (ll j = i + 1; j < size; ++j) {
+                best = best_of(best, Candidate { overlap(v[i], v[j]), i, j });
+                best = best_of(best, Candidate { overlap(v[j], v[i]), j, i });
+            }
+        }
+        clock.stop();
+    }
+
+    auto treduce = std::chrono::high_resolution_clock::now();
+    best = best_over_ranks(best);
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(treduce - tstart).count());
+    add_paralel_time (Phase::reduction, std::chrono::duration<double>(tend - treduce).count());
+    return Pair<StringId,StringId>{ v[best.i], v[best.j] };
+}
+
+// mesmo argmax por blocos de tile x tile do triangulo; cada iteracao e um bloco
+template <typename Overlap>
+inline auto highest_overlap_value_tiled(const std::vector<StringId>& v, Size tile, Overlap overlap) -> Pair<StringId,StringId> {
+    ll size = v.size();
+    ll b = (ll) tile;
+    ll blocks = (size + b - 1) / b;
+    Candidate best = no_candidate();
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    ll first = rank_number ();
+    ll step = rank_count ();
+
+    #pragma omp parallel reduction(best_candidate : best)
+    {
+        ThreadClock clock;
+        #pragma omp for schedule(dynamic) nowait
+        for (ll k = first; k < blocks * blocks; k += step) {
+            ll ib = k / blocks * b;
+            ll jb = k % blocks * b;
+            if (jb < ib) continue;
+            for (ll i = ib; i < std::min(ib + b, size); ++i) {
+                for (ll j = std::max(jb, i + 1); j < std::min(jb + b, size); ++j) {
+                    best = best_of(best, Candidate { overlap(v[i], v[j]), i, j });
+                    best = best_of(best, Candidate { overlap(v[j], v[i]), j, i });
+                }
+            }
+        }
+        clock.stop();
+    }
+
+    auto treduce = std::chrono::high_resolution_clock::now();
+    best = best_over_ranks(best);
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(treduce - tstart).count());
+    add_paralel_time (Phase::reduction, std::chrono::duration<double>(tend - treduce).count());
+    return Pair<StringId,StringId>{ v[best.i], v[best.j] };
+}
+
+// mesmo argmax, com blocos do espaco (i, j) distribuidos por roubo de trabalho
+template <typename Overlap>
+inline auto highest_overlap_value_stealing(const std::vector<StringId>& v, Size tile, Overlap overlap) -> Pair<StringId,StringId> {
+    ll size = v.size();
+    std::vector<Candidate> local(thread_count(), no_candidate());
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    // cada processo fica com uma faixa contigua de linhas
+    ll first = size * rank_number () / rank_count ();
+    ll last = size * (rank_number () + 1) / rank_count ();
+    for_each_tile_stealing(last - first, size, [&](const Tile& t, Size thread) {
+        Candidate best = local[thread];
+        Tile rows = { t.row_begin + first, t.row_end + first, t.column_begin, t.column_end };
+        for_each_cell_blocked(rows, tile, [&](ll i, ll j) {
+            if (i != j) best = best_of(best, Candidate { overlap(v[i], v[j]), i, j });
+        });
+        local[thread] = best;
+    });
+
+    auto treduce = std::chrono::high_resolution_clock::now();
+    Candidate best = no_candidate();
+    for (const Candidate& c : local) best = best_of(best, c);
+    best = best_over_ranks(best);
+
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(treduce - tstart).count());
+    add_paralel_time (Phase::reduction, std::chrono::duration<double>(tend - treduce).count());
+    return Pair<StringId,StringId>{ v[best.i], v[best.j] };
+}
+
+// overlap (a, b) e o kernel, por ids da arena
+template <typename Overlap> auto
+pair_of_strings_with_highest_overlap_value
+        (const std::vector <StringId>& v, Scheduler scheduler, Size tile, Overlap overlap) -> Pair <StringId, StringId>
+{
+    if (v.size () < 2) return Pair<StringId,StringId>{v[0], v[0]};
+
+    if (scheduler == Scheduler::stealing) return highest_overlap_value_stealing(v, tile, overlap);
+    if (tile != 0) return highest_overlap_value_tiled(v, tile, overlap);
+    return highest_overlap_value(v, overlap); 
+}
+
+inline auto pair_of_strings_with_highest_overlap_value
+        (const StringArena& arena, const std::vector <StringId>& v, Scheduler scheduler, Size tile) -> Pair <StringId, StringId>
+{
+    return pair_of_strings_with_highest_overlap_value
+        ( v, scheduler, tile, [&arena] (StringId a, StringId b) { return arena.overlap (a, b) ; } ) ;
+}
+
+inline auto arena_from_strings (const Strings& t, std::vector <StringId>& ids, Encoding encoding) -> StringArena
+{
+    StringArena arena ;
+    if (encoding == Encoding::packed) arena.enable_packing (SmallAlphabet::of (t)) ;
+    Size total = 0 ;
+    for (StringView s : t) total += s.length ;
+    arena.bytes.reserve (2 * total) ;
+    ids.reserve (size (t)) ;
+    for (StringView s : t) ids.push_back (arena.add (s)) ;
+    return arena ;
+}
+
+// uma fusao, em ids da arena: as entradas sao 0 .. n - 1 e a k-esima fusao
+// cria o id n + k, mesmo que o resultado repita uma string que ja existe
+struct Merge
+{
+    Size left ;
+    Size right ;
+    OverlapSize overlap ;
+} ;
+
+template <typename Overlap> inline auto
+greedy_merges
+        ( StringArena& arena
+        , std::vector <StringId>& ss
+        , const Options& options
+        , Overlap overlap
+        , std::vector <Merge>* merges ) -> String
+{
+    Size tile = tile_size_for (options.tile, size (ss), size (arena.bytes)) ;
+    while (at_least_two_elements_in (ss)) {
+        auto tstart = std::chrono::high_resolution_clock::now();
+        Pair <StringId, StringId> p = pair_of_strings_with_highest_overlap_value (ss, options.scheduler, tile, overlap) ;
+        auto tmerge = std::chrono::high_resolution_clock::now();
+        OverlapSize k = overlap (p.first, p.second) ;
+        if (merges) merges->push_back (Merge { p.first, p.second, k }) ;
+        ss = pop_two_elements_and_push_overlap (arena, ss, p, k) ;
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_phase_time (Phase::merge, std::chrono::duration<double>(tend - tmerge).count());
+        record_iteration (std::chrono::duration<double>(tend - tstart).count());
+    }
+    return to_string (arena [ss [0]]) ;
+}
+
+inline auto
+shortest_superstring (const Strings& t, const Options& options = Options (), std::vector <Merge>* merges = nullptr) -> String
+{
+    if (empty (t)) return "" ;
+    std::vector <StringId> ss ;
+    StringArena arena = arena_from_strings (t, ss, options.encoding) ;
+    return greedy_merges (arena, ss, options, [&arena] (StringId a, StringId b) { return arena.overlap (a, b) ; }, merges) ;
+}
+
+// ---------------------------------------------------------------------------
+// Motor incremental: a matriz de sobreposicoes e calculada uma unica vez e,
+// a cada fusao (s, t) -> m, so a linha e a coluna de m sao atualizadas.
+// m termina com t e comeca com s, entao ov(m, x) = ov(t, x) a menos que t
+// ocorra em x, e ov(x, m) = ov(x, s) a menos que s ocorra em x.
+// ---------------------------------------------------------------------------
+
+struct RowBest
+{
+    OverlapSize value ;
+    ll column ;
+} ;
+
+// fragmentos dos motores com matriz: a posicao (slot) i guarda o id do
+// fragmento que hoje ocupa a linha/coluna i. Em modo corda (Rope), id [i]
+// e a primeira entrada do fragmento e tail [i] a ultima; fora dele, as duas
+// sao o fragmento inteiro.
+struct Fragments
+{
+    using size_type = Size ;
+
+    StringArena arena ;
+    std::vector <StringId> id ;
+    std::vector <StringId> tail ;
+
+    auto operator[] (Size slot) const -> StringView { return arena [id [slot]] ; }
+    auto last (Size slot) const -> StringView { return arena [tail [slot]] ; }
+    auto overlap (Size i, Size j) const -> OverlapSize { return arena.overlap (tail [i], id [j]) ; }
+
+    auto views () const -> Strings
+    {
+        Strings x ;
+        for (StringId i : id) x.push_back (arena [i]) ;
+        return x ;
+    }
+    auto size () const -> Size { return id.size () ; }
+} ;
+
+inline auto fragments_from_strings (const Strings& t, Encoding encoding) -> Fragments
+{
+    Fragments fragments ;
+    fragments.arena = arena_from_strings (t, fragments.id, encoding) ;
+    fragments.tail = fragments.id ;
+    return fragments ;
+}
+
+struct ContentHash
+{
+    const StringArena* arena ;
+
+    auto operator() (StringId id) const -> Size
+    {
+        StringView x = (*arena) [id] ;
+        Size h = 1469598103934665603ull ;
+        for (Size i = 0; i < x.length; ++i) h = (h ^ (unsigned char) x.data [i]) * 1099511628211ull ;
+        return h ;
+    }
+} ;
+
+struct ContentEqual
+{
+    const StringArena* arena ;
+
+    auto operator() (StringId a, StringId b) const -> Boolean { return (*arena) [a] == (*arena) [b] ; }
+} ;
+
+// mesma ordem de highest_overlap_value: maior sobreposicao, depois o par
+// de strings em ordem lexicografica
+inline auto better_candidate
+        ( const Fragments& fragments
+        , OverlapSize a_value, Size a_row, Size a_column
+        , OverlapSize b_value, Size b_row, Size b_column ) -> Boolean
+{
+    if (a_value != b_value) return a_value > b_value ;
+    if (a_row != b_row) return fragments [a_row] < fragments [b_row] ;
+    return fragments [a_column] < fragments [b_column] ;
+}
+
+// celulas estreitas (uint8_t, uint16_t) quando o maior fragmento cabe nelas;
+// um valor que nao cabe fica saturado e e recalculado na leitura, o que
+// tambem cobre os fragmentos que crescem com as fusoes
+template <typename Cell>
+struct OverlapMatrix
+{
+    const Fragments* fragments ;
+    Size n ;
+    std::vector <Cell> cells ;
+
+    explicit OverlapMatrix (const Fragments& f) : fragments (&f), n (size (f)), cells (n * n, 0) { count_allocation () ; }
+
+    static auto saturated () -> OverlapSize { return std::numeric_limits <Cell>::max () ; }
+
+    auto set (Size i, Size j, OverlapSize v) -> void { cells [i * n + j] = (Cell) std::min (v, saturated ()) ; }
+    auto at (Size i, Size j) const -> OverlapSize
+    {
+        OverlapSize v = cells [i * n + j] ;
+        return v < saturated () ? v : fragments->overlap (i, j) ;
+    }
+    // copia sem recalcular: saturado continua saturado
+    auto copy (Size i, Size j, Size from_i, Size from_j) -> void { cells [i * n + j] = cells [from_i * n + from_j] ; }
+
+    // leitura em pipeline: a posicao i passa a ser a antiga order [i]; as
+    // posicoes que nao existiam ficam zeradas
+    auto reorder (const std::vector <Size>& order, Size count) -> void
+    {
+        std::vector <Cell> moved (count * count, 0) ;
+        #pragma omp parallel for schedule(static)
+        for (ll i = 0; i < (ll) size (order); ++i) {
+            const Cell* from = cells.data () + order [(Size) i] * n ;
+            Cell* to = moved.data () + (Size) i * count ;
+            for (Size j = 0; j < size (order); ++j) to [j] = from [order [j]] ;
+        }
+        cells.swap (moved) ;
+        n = count ;
+        count_allocation () ;
+    }
+} ;
+
+inline auto cell_bytes_for (const Fragments& fragments) -> Size
+{
+    Size longest = 0 ;
+    for (Size i = 0; i < size (fragments); ++i) longest = std::max (longest, fragments [i].length) ;
+    if (longest < std::numeric_limits <std::uint8_t>::max ()) return 1 ;
+    if (longest < std::numeric_limits <std::uint16_t>::max ()) return 2 ;
+    return 4 ;
+}
+
+template <typename Cell> inline auto
+best_in_row
+        ( const OverlapMatrix <Cell>& m
+        , const Fragments& fragments
+        , const std::vector <char>& alive
+        , Size i ) -> RowBest
+{
+    RowBest best = { 0, -1 } ;
+    for (Size j = 0; j < m.n; ++j) {
+        if (j == i || ! alive [j]) continue ;
+        OverlapSize value = m.at (i, j) ;
+        if ( best.column < 0
+                || better_candidate (fragments, value, i, j, best.value, i, (Size) best.column) ) {
+            best.value = value ;
+            best.column = (ll) j ;
+        }
+    }
+    return best ;
+}
+
+// ov (u, s) para a coluna nova de s, ou -1 se nao pode passar do melhor
+// que best_in_row achou para u
+template <typename Cell> inline auto
+column_candidate (const OverlapMatrix <Cell>& m, Size u, Size s) -> ll
+{
+    return (ll) m.at (u, s) ;
+}
+
+template <typename Cell> inline auto
+fill_overlap_matrix (const Fragments& fragments, Scheduler scheduler, Size tile) -> OverlapMatrix <Cell>
+{
+    OverlapMatrix <Cell> m (fragments) ;
+    auto tstart = std::chrono::high_resolution_clock::now();
+    auto cell = [&] (ll i, ll j) {
+        if (i != j) m.set ((Size) i, (Size) j, fragments.overlap ((Size) i, (Size) j)) ;
+    } ;
+
+    if (scheduler == Scheduler::stealing) {
+        for_each_tile_stealing ((ll) m.n, (ll) m.n, [&] (const Tile& t, Size) {
+            for_each_cell_blocked (t, tile, cell) ;
+        }) ;
+    } else if (tile != 0) {
+        ll blocks = ((ll) m.n + (ll) tile - 1) / (ll) tile ;
+        #pragma omp parallel
+        {
+            ThreadClock clock ;
+            #pragma omp for schedule(dynamic) nowait
+            for (ll k = 0; k < blocks * blocks; ++k) {
+                ll ib = k / blocks * (ll) tile ;
+                ll jb = k % blocks * (ll) tile ;
+                Tile t = { ib, std::min (ib + (ll) tile, (ll) m.n), jb, std::min (jb + (ll) tile, (ll) m.n) } ;
+                for_each_cell_blocked (t, tile, cell) ;
+            }
+            clock.stop () ;
+        }
+    } else {
+        #pragma omp parallel
+        {
+            ThreadClock clock ;
+            #pragma omp for schedule(dynamic) nowait
+            for (ll i = 0; i < (ll) m.n; ++i) {
+                for (Size j = 0; j < m.n; ++j) cell (i, (ll) j) ;
+            }
+            clock.stop () ;
+        }
+    }
+
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+    return m ;
+}
+
+// ---------------------------------------------------------------------------
+// Estagio de sobreposicoes todos-contra-todos (estilo Gusfield): um automato
+// de Aho-Corasick sobre todas as strings. Como as strings estao ordenadas,
+// as que tem um no da trie como prefixo formam o intervalo [first, last).
+// Lendo a[1..] no automato, a cadeia de falhas do estado final lista, da mais
+// longa para a mais curta, os sufixos proprios de a que sao prefixo de algo.
+// ---------------------------------------------------------------------------
+
+struct OverlapAutomaton
+{
+    struct Node
+    {
+        char symbol ;
+        int child ;
+        int sibling ;
+        int fail ;
+        Size depth ;
+        Size first ;
+        Size last ;
+        int word ;
+        int output ;
+    } ;
+
+    std::vector <Node> nodes ;
+
+    explicit OverlapAutomaton (const Strings& sorted)
+    {
+        nodes.push_back (Node { 0, -1, -1, 0, 0, 0, size (sorted), -1, -1 }) ;
+        for (Size i = 0; i < size (sorted); ++i) {
+            int v = 0 ;
+            StringView x = sorted [i] ;
+            for (Size p = 0; p < x.length; ++p) {
+                char c = x.data [p] ;
+                int u = child (v, c) ;
+                if (u < 0) {
+                    u = (int) size (nodes) ;
+                    nodes.push_back (Node { c, -1, nodes [v].child, 0, nodes [v].depth + 1, i, i, -1, -1 }) ;
+                    nodes [v].child = u ;
+                }
+                nodes [u].last = i + 1 ;
+                v = u ;
+            }
+            nodes [v].word = (int) i ;
+        }
+
+        std::vector <int> queue (1, 0) ;
+        for (Size head = 0; head < size (queue); ++head) {
+            int v = queue [head] ;
+            for (int u = nodes [v].child; u >= 0; u = nodes [u].sibling) {
+                if (v != 0) nodes [u].fail = next (nodes [v].fail, nodes [u].symbol) ;
+                const Node& f = nodes [nodes [u].fail] ;
+                nodes [u].output = f.word >= 0 ? nodes [u].fail : f.output ;
+                queue.push_back (u) ;
+            }
+        }
+    }
+
+    auto child (int v, char c) const -> int
+    {
+        for (int u = nodes [v].child; u >= 0; u = nodes [u].sibling)
+            if (nodes [u].symbol == c) return u ;
+        return -1 ;
+    }
+
+    auto next (int v, char c) const -> int
+    {
+        for (;;) {
+            int u = child (v, c) ;
+            if (u >= 0) return u ;
+            if (v == 0) return 0 ;
+            v = nodes [v].fail ;
+        }
+    }
+} ;
+
+// ---------------------------------------------------------------------------
+// Pre-filtro de contencao: cada string e lida no automato e, em cada
+// posicao, a cadeia de saidas lista as strings que terminam ali. Quem
+// aparece dentro de outra string nao muda a resposta e sai do conjunto.
+// Se uma string ja foi marcada, tudo abaixo dela na cadeia tambem foi.
+// ---------------------------------------------------------------------------
+
+// marca as palavras do automato que aparecem em algum texto; com self, o
+// texto i e a palavra i e nao conta
+inline auto mark_occurrences
+        ( const OverlapAutomaton& automaton
+        , const Strings& texts
+        , Boolean self
+        , std::vector <std::atomic <char>>& contained ) -> void
+{
+    #pragma omp parallel for schedule(dynamic)
+    for (ll i = 0; i < (ll) size (texts); ++i) {
+        StringView x = texts [(Size) i] ;
+        int state = 0 ;
+        for (Size p = 0; p <= x.length; ++p) {
+            if (p > 0) state = automaton.next (state, x.data [p - 1]) ;
+            const OverlapAutomaton::Node& v = automaton.nodes [state] ;
+            for (int u = v.word >= 0 ? state : v.output; u >= 0; u = automaton.nodes [u].output) {
+                int j = automaton.nodes [u].word ;
+                if (self && j == (int) i) continue ;
+                if (contained [(Size) j].exchange (1, std::memory_order_relaxed)) break ;
+            }
+        }
+    }
+}
+
+// contained [i] = 1 se t [i] aparece dentro de outra string de t ou de
+// others; others nao repete strings de t e so e lido, sem entrar no automato
+inline auto contained_strings (const Strings& t, const Strings& others = Strings ()) -> std::vector <char>
+{
+    Size n = size (t) ;
+    if (n == 0 || (n == 1 && empty (others))) return std::vector <char> (n, 0) ;
+
+    OverlapAutomaton automaton (t) ;
+    std::vector <std::atomic <char>> contained (n) ;
+    for (Size i = 0; i < n; ++i) contained [i].store (0, std::memory_order_relaxed) ;
+    mark_occurrences (automaton, t, true, contained) ;
+    mark_occurrences (automaton, others, false, contained) ;
+
+    std::vector <char> flags (n) ;
+    for (Size i = 0; i < n; ++i) flags [i] = contained [i].load (std::memory_order_relaxed) ;
+    return flags ;
+}
+
+inline auto drop_contained_strings (Strings& t) -> Size
+{
+    if (size (t) < 2) return 0 ;
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    std::vector <char> contained = contained_strings (t) ;
+    Strings kept ;
+    for (Size i = 0; i < size (t); ++i) if (! contained [i]) kept.push_back (t [i]) ;
+    Size removed = size (t) - size (kept) ;
+    t.swap (kept) ;
+
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
+    return removed ;
+}
+
+inline auto next_unassigned (std::vector <Size>& skip, Size j) -> Size
+{
+    while (skip [j] != j) {
+        skip [j] = skip [skip [j]] ;
+        j = skip [j] ;
+    }
+    return j ;
+}
+
+// chama row (j, ov) para cada j com ov(a, j) > 0, inclusive a propria linha
+template <typename Row> inline auto
+overlap_row_with_automaton
+        ( const OverlapAutomaton& automaton
+        , StringView a
+        , std::vector <Size>& skip
+        , Row row ) -> void
+{
+    int state = 0 ;
+    for (Size p = 1; p < a.length; ++p) state = automaton.next (state, a.data [p]) ;
+
+    for (Size j = 0; j < size (skip); ++j) skip [j] = j ;
+    for (; state != 0; state = automaton.nodes [state].fail) {
+        const OverlapAutomaton::Node& v = automaton.nodes [state] ;
+        for (Size j = next_unassigned (skip, v.first); j < v.last; j = next_unassigned (skip, j)) {
+            row (j, v.depth) ;
+            skip [j] = j + 1 ;
+        }
+    }
+}
+
+template <typename Cell> inline auto
+fill_overlap_matrix_with_automaton (const Fragments& fragments) -> OverlapMatrix <Cell>
+{
+    OverlapMatrix <Cell> m (fragments) ;
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    OverlapAutomaton automaton (fragments.views ()) ;
+
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        std::vector <Size> skip (m.n + 1) ;
+
+        #pragma omp for schedule(dynamic) nowait
+        for (ll i = 0; i < (ll) m.n; ++i) {
+            overlap_row_with_automaton (automaton, fragments [(Size) i], skip, [&] (Size j, OverlapSize v) {
+                if (j != (Size) i) m.set ((Size) i, j, v) ;
+            }) ;
+            count_work (m.n - 1, fragments [(Size) i].length) ;
+        }
+        clock.stop () ;
+    }
+
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+    return m ;
+}
+
+template <typename Cell> inline auto
+fill_overlap_matrix_for (const Fragments& fragments, const Options& options) -> OverlapMatrix <Cell>
+{
+    if (options.overlaps == OverlapStage::automaton) return fill_overlap_matrix_with_automaton <Cell> (fragments) ;
+    Size tile = tile_size_for (options.tile, size (fragments), size (fragments.arena.bytes)) ;
+    return fill_overlap_matrix <Cell> (fragments, options.scheduler, tile) ;
+}
+
+// ---------------------------------------------------------------------------
+// Armazenamento esparso (--max-mem): quando a matriz densa passa do
+// orcamento, cada linha guarda so as sobreposicoes acima de um piso, no
+// maximo k ao ser montada. Toda coluna viva fora da lista tem sobreposicao
+// <= piso, entao enquanto houver coluna viva na lista o melhor da linha esta
+// nela; quando a lista acaba a linha e recalculada inteira. Valores fora da
+// lista sao calculados na hora, entao o resultado e o mesmo da matriz densa.
+// ---------------------------------------------------------------------------
+
+struct SparseEntry
+{
+    std::uint32_t column ;
+    std::uint32_t value ;
+} ;
+
+// ---------------------------------------------------------------------------
+// Indice de sementes (--seed=k): slots pelo hash do prefixo de tamanho k.
+// ov(i, j) >= k so se o prefixo de j aparece em i numa posicao p >= 1, entao
+// a linha i so calcula as colunas achadas deslizando o hash por i; as que
+// ficam de fora tem sobreposicao < k. Abaixo de k, ov (i, j) = q exige o
+// sufixo de q caracteres de i igual ao prefixo de q caracteres de j, entao
+// os prefixos de 1 a k - 1 caracteres tambem sao indexados e essas
+// sobreposicoes saem sem calcular par. Uma fusao mantem o prefixo do slot,
+// e o indice vale ate o fim. Strings menores que k sao sempre candidatas.
+// ---------------------------------------------------------------------------
+
+struct SeedIndex
+{
+    static const std::uint64_t base = 1099511628211ull ;
+
+    Size k ;
+    std::uint64_t top ;
+    std::unordered_map <std::uint64_t, std::vector <std::uint32_t>> slots ;
+    std::vector <std::uint32_t> short_slots ;
+    // prefixes [q - 1]: slots pelo hash do prefixo de q < k caracteres
+    std::vector <std::unordered_map <std::uint64_t, std::vector <std::uint32_t>>> prefixes ;
+
+    SeedIndex (const Fragments& fragments, Size k) : k (k), top (1), prefixes (k - 1)
+    {
+        for (Size q = 1; q < k; ++q) top *= base ;
+        for (Size j = 0; j < size (fragments); ++j) {
+            StringView x = fragments [j] ;
+            if (x.length < k) {
+                short_slots.push_back ((std::uint32_t) j) ;
+                continue ;
+            }
+            slots [hash (x.data)].push_back ((std::uint32_t) j) ;
+            std::uint64_t h = 0 ;
+            for (Size q = 1; q < k; ++q) {
+                h = h * base + (unsigned char) x.data [q - 1] ;
+                prefixes [q - 1] [h].push_back ((std::uint32_t) j) ;
+            }
+        }
+    }
+
+    auto hash (const char* x) const -> std::uint64_t
+    {
+        std::uint64_t h = 0 ;
+        for (Size q = 0; q < k; ++q) h = h * base + (unsigned char) x [q] ;
+        return h ;
+    }
+
+    // slots que podem ter ov (a, j) >= k, com repeticoes
+    auto candidates (StringView a, std::vector <std::uint32_t>& out) const -> void
+    {
+        out.assign (short_slots.begin (), short_slots.end ()) ;
+        if (a.length <= k) return ;
+        std::uint64_t h = hash (a.data + 1) ;
+        for (Size p = 1; ; ++p) {
+            auto it = slots.find (h) ;
+            if (it != slots.end ()) out.insert (out.end (), it->second.begin (), it->second.end ()) ;
+            if (p + k == a.length) break ;
+            h = (h - top * (unsigned char) a.data [p]) * base + (unsigned char) a.data [p + k] ;
+        }
+    }
+} ;
+
+// ---------------------------------------------------------------------------
+// Armazenamento esparso (--max-mem, --seed): cada linha guarda so as
+// sobreposicoes acima de um piso, cerca de k ao ser montada. Toda coluna
+// viva fora da lista tem sobreposicao <= piso, entao enquanto houver coluna
+// viva na lista o melhor da linha esta nela; quando a lista acaba a linha e
+// recalculada: sem sementes contra todas as colunas; com elas, primeiro as
+// sobreposicoes >= k e depois um nivel q < k de cada vez, pelos prefixos
+// curtos. Valores fora da lista sao calculados na hora, entao o resultado e
+// o mesmo da matriz densa.
+// ---------------------------------------------------------------------------
+
+struct SparseOverlaps
+{
+    const Fragments* fragments ;
+    const SeedIndex* seeds ;
+    Size n ;
+    Size k ;
+    std::vector <std::vector <SparseEntry>> rows ;
+    std::vector <OverlapSize> floor ;
+
+    SparseOverlaps (const Fragments& f, const SeedIndex* seeds, Size k)
+        : fragments (&f), seeds (seeds), n (size (f)), k (k), rows (n), floor (n, 0) {}
+
+    auto at (Size i, Size j) const -> OverlapSize
+    {
+        for (const SparseEntry& e : rows [i]) if (e.column == j) return e.value ;
+        return fragments->overlap (i, j) ;
+    }
+
+    // (i, j) passou a valer v: entra na lista se ficou acima do piso
+    auto update (Size i, Size j, OverlapSize v) -> void
+    {
+        std::vector <SparseEntry>& row = rows [i] ;
+        auto it = std::find_if (row.begin (), row.end (), [j] (const SparseEntry& e) { return e.column == j ; }) ;
+        if (v > floor [i]) {
+            if (it == row.end ()) row.push_back (SparseEntry { (std::uint32_t) j, (std::uint32_t) v }) ;
+            else it->value = (std::uint32_t) v ;
+        } else if (it != row.end ()) {
+            row.erase (it) ;
+        }
+    }
+
+    // found: colunas vivas da linha i com sobreposicao > minimum, e as que
+    // nao estao em found tem sobreposicao <= minimum. Empates no corte ficam
+    // todos dentro ou todos fora, entao a lista so fica vazia se found estiver.
+    auto rebuild (Size i, std::vector <SparseEntry>& found, OverlapSize minimum) -> void
+    {
+        floor [i] = minimum ;
+        if (size (found) > k) {
+            auto before = [] (const SparseEntry& a, const SparseEntry& b) { return a.value > b.value ; } ;
+            std::nth_element (found.begin (), found.begin () + (ll) k, found.end (), before) ;
+            OverlapSize cut = found [k].value ;
+            if (found [0].value > cut) {
+                floor [i] = std::max (minimum, cut) ;
+            } else {
+                for (const SparseEntry& e : found) if (e.value < cut) floor [i] = std::max <OverlapSize> (floor [i], e.value) ;
+            }
+        }
+        std::vector <SparseEntry> row ;
+        for (const SparseEntry& e : found) if (e.value > floor [i]) row.push_back (e) ;
+        rows [i].swap (row) ;
+        count_allocation () ;
+    }
+} ;
+
+// linhas de k entradas e o piso de cada linha cabem em budget bytes
+inline auto sparse_row_capacity (Size n, Size budget) -> Size
+{
+    if (budget == 0) return n ;
+    Size per_row = budget / std::max <Size> (1, n) ;
+    Size overhead = sizeof (std::vector <SparseEntry>) + sizeof (OverlapSize) ;
+    return std::max <Size> (1, per_row > overhead ? (per_row - overhead) / sizeof (SparseEntry) : 0) ;
+}
+
+inline auto positive_overlaps
+        ( const Fragments& fragments
+        , const std::vector <char>& alive
+        , Size i ) -> std::vector <SparseEntry>
+{
+    std::vector <SparseEntry> positive ;
+    for (Size j = 0; j < size (fragments); ++j) {
+        if (j == i || ! alive [j]) continue ;
+        OverlapSize v = fragments.overlap (i, j) ;
+        if (v > 0) positive.push_back (SparseEntry { (std::uint32_t) j, (std::uint32_t) v }) ;
+    }
+    return positive ;
+}
+
+// colunas com ov (i, j) >= seeds.k, calculadas so entre as candidatas
+inline auto seeded_overlaps
+        ( const Fragments& fragments
+        , const SeedIndex& seeds
+        , const std::vector <char>& alive
+        , Size i ) -> std::vector <SparseEntry>
+{
+    std::vector <std::uint32_t> candidates ;
+    seeds.candidates (fragments.last (i), candidates) ;
+    std::sort (candidates.begin (), candidates.end ()) ;
+    candidates.erase (std::unique (candidates.begin (), candidates.end ()), candidates.end ()) ;
+
+    std::vector <SparseEntry> found ;
+    for (std::uint32_t j : candidates) {
+        if (j == i || ! alive [j]) continue ;
+        OverlapSize v = fragments.overlap (i, j) ;
+        if (v >= seeds.k) found.push_back (SparseEntry { j, (std::uint32_t) v }) ;
+    }
+    return found ;
+}
+
+// piso < k: as colunas do maior nivel q <= piso que tem alguma viva com o
+// sufixo de q caracteres de i igual ao prefixo de q caracteres dela, e as
+// strings curtas calculadas direto. Devolve o novo piso, q - 1: uma coluna
+// viva com ov (i, j) > q - 1 estaria nesse nivel, porque acima dele nao ha
+// nenhuma.
+inline auto short_overlaps
+        ( const Fragments& fragments
+        , const SeedIndex& seeds
+        , const std::vector <char>& alive
+        , Size i
+        , OverlapSize floor
+        , std::vector <SparseEntry>& found ) -> OverlapSize
+{
+    OverlapSize top = 0 ;
+    for (std::uint32_t j : seeds.short_slots) {
+        if (j == i || ! alive [j]) continue ;
+        OverlapSize v = fragments.overlap (i, j) ;
+        if (v == 0) continue ;
+        found.push_back (SparseEntry { j, (std::uint32_t) v }) ;
+        top = std::max (top, v) ;
+    }
+
+    // como em overlap_length, ov (i, j) < |a|
+    StringView a = fragments.last (i) ;
+    Size lowest = std::max <Size> (1, top) ;
+    Size highest = std::min <Size> (floor, a.length > 0 ? a.length - 1 : 0) ;
+    std::vector <std::uint64_t> suffix (highest + 1, 0) ;
+    std::uint64_t power = 1 ;
+    for (Size q = 1; q <= highest; ++q) {
+        suffix [q] = suffix [q - 1] + power * (unsigned char) a.data [a.length - q] ;
+        power *= SeedIndex::base ;
+    }
+    for (Size q = highest; q >= lowest; --q) {
+        Size before = size (found) ;
+        auto it = seeds.prefixes [q - 1].find (suffix [q]) ;
+        if (it != seeds.prefixes [q - 1].end ()) {
+            for (std::uint32_t j : it->second) {
+                if (j == i || ! alive [j]) continue ;
+                if (std::memcmp (a.data + a.length - q, fragments [j].data, q) != 0) continue ;
+                found.push_back (SparseEntry { j, (std::uint32_t) q }) ;
+            }
+        }
+        if (size (found) > before || q == lowest) return (OverlapSize) (q - 1) ;
+    }
+    return (OverlapSize) (lowest - 1) ;
+}
+
+// recalcula a linha i; com sementes, pelo indice em todos os niveis
+inline auto refill_row (SparseOverlaps& m, const Fragments& fragments, const std::vector <char>& alive, Size i) -> void
+{
+    if (m.seeds && m.floor [i] >= m.seeds->k) {
+        std::vector <SparseEntry> found = seeded_overlaps (fragments, *m.seeds, alive, i) ;
+        m.rebuild (i, found, m.seeds->k - 1) ;
+    } else if (m.seeds) {
+        std::vector <SparseEntry> found ;
+        OverlapSize minimum = short_overlaps (fragments, *m.seeds, alive, i, m.floor [i], found) ;
+        m.rebuild (i, found, minimum) ;
+    } else {
+        std::vector <SparseEntry> found = positive_overlaps (fragments, alive, i) ;
+        m.rebuild (i, found, 0) ;
+    }
+}
+
+inline auto fill_sparse_overlaps
+        ( const Fragments& fragments
+        , const SeedIndex* seeds
+        , const Options& options
+        , Size k ) -> SparseOverlaps
+{
+    SparseOverlaps m (fragments, seeds, k) ;
+    std::vector <char> alive (m.n, 1) ;
+    auto tstart = std::chrono::high_resolution_clock::now();
+
+    std::unique_ptr <OverlapAutomaton> automaton ;
+    if (options.overlaps == OverlapStage::automaton) automaton.reset (new OverlapAutomaton (fragments.views ())) ;
+
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        std::vector <Size> skip (m.n + 1) ;
+
+        #pragma omp for schedule(dynamic) nowait
+        for (ll x = 0; x < (ll) m.n; ++x) {
+            Size i = (Size) x ;
+            if (automaton) {
+                std::vector <SparseEntry> positive ;
+                overlap_row_with_automaton (*automaton, fragments [i], skip, [&] (Size j, OverlapSize v) {
+                    if (j != i) positive.push_back (SparseEntry { (std::uint32_t) j, (std::uint32_t) v }) ;
+                }) ;
+                count_work (m.n - 1, fragments [i].length) ;
+                m.rebuild (i, positive, 0) ;
+            } else {
+                m.floor [i] = std::numeric_limits <OverlapSize>::max () ;
+                refill_row (m, fragments, alive, i) ;
+            }
+        }
+        clock.stop () ;
+    }
+
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+    return m ;
+}
+
+inline auto best_in_row
+        ( SparseOverlaps& m
+        , const Fragments& fragments
+        , const std::vector <char>& alive
+        , Size i ) -> RowBest
+{
+    std::vector <SparseEntry>& row = m.rows [i] ;
+    row.erase (std::remove_if (row.begin (), row.end (), [&] (const SparseEntry& e) {
+        return e.column == i || ! alive [e.column] ;
+    }), row.end ()) ;
+    while (empty (row) && m.floor [i] > 0) refill_row (m, fragments, alive, i) ;
+
+    RowBest best = { 0, -1 } ;
+    for (const SparseEntry& e : row) {
+        if ( best.column < 0
+                || better_candidate (fragments, e.value, i, e.column, best.value, i, (Size) best.column) ) {
+            best.value = e.value ;
+            best.column = (ll) e.column ;
+        }
+    }
+    if (best.column >= 0) return best ;
+
+    // linha toda zero: desempate pela menor coluna viva
+    for (Size j = 0; j < m.n; ++j) {
+        if (j == i || ! alive [j]) continue ;
+        if (best.column < 0 || fragments [j] < fragments [(Size) best.column]) best.column = (ll) j ;
+    }
+    return best ;
+}
+
+// fora da lista ov (u, s) <= piso, sem calcular: best_in_row so deixa a
+// linha sem lista com piso 0, e um melhor tirado da lista ja passa do piso
+inline auto column_candidate (const SparseOverlaps& m, Size u, Size s) -> ll
+{
+    for (const SparseEntry& e : m.rows [u]) if (e.column == s) return (ll) e.value ;
+    return m.floor [u] == 0 ? 0 : -1 ;
+}
+
+inline auto live_ids (const Fragments& fragments, const std::vector <char>& alive) -> std::vector <StringId>
+{
+    std::vector <StringId> live ;
+    for (Size i = 0; i < size (fragments); ++i) if (alive [i]) live.push_back (fragments.id [i]) ;
+    return live ;
+}
+
+inline auto row_with_highest_overlap_value
+        ( const Fragments& fragments
+        , const std::vector <char>& alive
+        , const std::vector <RowBest>& best ) -> ll
+{
+    ll best_row = -1 ;
+    for (Size i = 0; i < size (fragments); ++i) {
+        if (! alive [i] || best [i].column < 0) continue ;
+        if ( best_row < 0
+                || better_candidate
+                    ( fragments
+                    , best [i].value, i, (Size) best [i].column
+                    , best [(Size) best_row].value, (Size) best_row, (Size) best [(Size) best_row].column ) )
+            best_row = (ll) i ;
+    }
+    return best_row ;
+}
+
+// m ja e o fragmento s: atualiza a linha e a coluna de s. Sem containment a
+// linha de m e a de t e a coluna e a de s, O(n); com containment, quem
+// contem s ou t e recalculado, o que custa um contains por fragmento vivo
+template <typename Cell> inline auto
+update_after_merge
+        ( OverlapMatrix <Cell>& m
+        , const Fragments& fragments
+        , const std::vector <char>& alive
+        , Size s, Size r
+        , StringView parent_s, StringView parent_t
+        , Boolean containment ) -> void
+{
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        #pragma omp for schedule(dynamic) nowait
+        for (ll x = 0; x < (ll) m.n; ++x) {
+            Size u = (Size) x ;
+            if (u == s || ! alive [u]) continue ;
+            StringView fu = fragments [u] ;
+            if (containment && contains (fu, parent_t)) m.set (s, u, fragments.overlap (s, u)) ;
+            else m.copy (s, u, r, u) ;
+            if (containment && contains (fu, parent_s)) m.set (u, s, fragments.overlap (u, s)) ;
+        }
+        clock.stop () ;
+    }
+}
+
+// a linha de m e a de t; so as colunas que contem t mudam
+inline auto update_after_merge
+        ( SparseOverlaps& m
+        , const Fragments& fragments
+        , const std::vector <char>& alive
+        , Size s, Size r
+        , StringView parent_s, StringView parent_t
+        , Boolean containment ) -> void
+{
+    m.rows [s].swap (m.rows [r]) ;
+    std::vector <SparseEntry> ().swap (m.rows [r]) ;
+    m.floor [s] = m.floor [r] ;
+    if (! containment) return ;
+
+    std::vector <Size> containing_t ;
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        #pragma omp for schedule(dynamic) nowait
+        for (ll x = 0; x < (ll) m.n; ++x) {
+            Size u = (Size) x ;
+            if (u == s || ! alive [u]) continue ;
+            StringView fu = fragments [u] ;
+            if (contains (fu, parent_s)) m.update (u, s, fragments.overlap (u, s)) ;
+            if (contains (fu, parent_t)) {
+                #pragma omp critical
+                containing_t.push_back (u) ;
+            }
+        }
+        clock.stop () ;
+    }
+    for (Size u : containing_t) m.update (s, u, fragments.overlap (s, u)) ;
+}
+
+// Corda: sem string contida em outra, o guloso nunca cria uma (se a fusao
+// (s, t) contivesse u, ov (s, u) passaria de ov (s, t)). Entao ov (m, x) =
+// ov (t, x), ov (x, m) = ov (x, s), m nunca repete um fragmento e a ordem
+// entre fragmentos e a das suas primeiras entradas, que diferem antes do
+// fim da menor. Cada fragmento e so a cadeia das suas entradas, com o corte
+// de cada uma: a fusao e O(1), nada e copiado e a superstring e montada
+// uma unica vez no fim.
+static const StringId rope_end = std::numeric_limits <StringId>::max () ;
+
+struct Rope
+{
+    std::vector <StringId> next ;
+    std::vector <OverlapSize> cut ;
+
+    explicit Rope (Size n) : next (n, rope_end), cut (n, 0) {}
+
+    // a cadeia que comeca em first passa a seguir a entrada last, com
+    // sobreposicao k (como remove_prefix, k do tamanho todo nao corta nada)
+    auto link (const StringArena& arena, StringId last, StringId first, OverlapSize k) -> void
+    {
+        next [last] = first ;
+        cut [first] = k < arena.lengths [first] ? k : 0 ;
+    }
+
+    auto materialize (const StringArena& arena, StringId first) const -> String
+    {
+        Size length = 0 ;
+        for (StringId u = first; u != rope_end; u = next [u]) length += arena.lengths [u] - cut [u] ;
+        String x ;
+        x.reserve (length) ;
+        for (StringId u = first; u != rope_end; u = next [u]) x.append (arena [u].data + cut [u], arena.lengths [u] - cut [u]) ;
+        return x ;
+    }
+} ;
+
+// entradas distintas do mesmo tamanho nao contem umas as outras
+inline auto same_length (const Strings& t) -> Boolean
+{
+    for (StringView x : t) if (x.length != t [0].length) return false ;
+    return true ;
+}
+
+// depois de uma fusao com contencao: marca quem ficou dentro de m e diz se m
+// esta dentro de algum fragmento vivo
+inline auto update_containment
+        ( const Fragments& fragments
+        , const std::vector <char>& alive
+        , std::vector <char>& inside
+        , Size s ) -> Boolean
+{
+    StringView merged = fragments [s] ;
+    Boolean contained = false ;
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        #pragma omp for schedule(dynamic) reduction(||:contained) nowait
+        for (ll x = 0; x < (ll) size (fragments); ++x) {
+            Size u = (Size) x ;
+            if (u == s || ! alive [u]) continue ;
+            if (contains (merged, fragments [u])) inside [u] = 1 ;
+            if (contains (fragments [u], merged)) contained = true ;
+        }
+        clock.stop () ;
+    }
+    return contained ;
+}
+
+template <typename Store> inline auto
+incremental_greedy (Fragments& fragments, Store& m, Boolean rope, std::vector <Merge>* merges) -> String
+{
+    Size n = size (fragments) ;
+    std::vector <char> alive (n, 1) ;
+    std::unordered_map <StringId, Size, ContentHash, ContentEqual> slot_of
+        ( rope ? 0 : n, ContentHash { &fragments.arena }, ContentEqual { &fragments.arena } ) ;
+    if (! rope) for (Size i = 0; i < n; ++i) slot_of [fragments.id [i]] = i ;
+    Rope chain (rope ? size (fragments.arena.offsets) : 0) ;
+    std::vector <StringId> label (fragments.id) ;
+
+    // inside [i]: o fragmento i pode estar contido noutro vivo. So quem
+    // contem s ou t tem a linha ou a coluna de m diferente das de t e s, e
+    // uma fusao (s, t) com s e t fora de tudo nao cria contencao nova: m so
+    // caberia em quem contem s, e uma u que cruzasse a juncao (comecando em
+    // s depois da posicao 0) teria ov (s, u) > ov (s, t), e o guloso teria
+    // escolhido (s, u). Entao a varredura de contains so roda nas fusoes
+    // com inside [s] ou inside [t], e o resto custa O(n) por iteracao.
+    std::vector <char> inside ;
+    if (! rope) {
+        auto tstart = std::chrono::high_resolution_clock::now();
+        inside = contained_strings (fragments.views ()) ;
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+    }
+    StringId created = (StringId) size (fragments.arena.offsets) ;
+
+    std::vector <RowBest> best (n) ;
+    for (Size i = 0; i < n; ++i) best [i] = best_in_row (m, fragments, alive, i) ;
+
+    Size remaining = n ;
+    while (remaining > 1) {
+        auto tbegin = std::chrono::high_resolution_clock::now();
+        Size s = (Size) row_with_highest_overlap_value (fragments, alive, best) ;
+        Size r = (Size) best [s].column ;
+        auto tchosen = std::chrono::high_resolution_clock::now();
+        add_phase_time (Phase::reduction, std::chrono::duration<double>(tchosen - tbegin).count());
+
+        OverlapSize k = m.at (s, r) ;
+        if (merges) merges->push_back (Merge { label [s], label [r], k }) ;
+        label [s] = created++ ;
+
+        if (rope) {
+            auto tstart = std::chrono::high_resolution_clock::now();
+            chain.link (fragments.arena, fragments.tail [s], fragments.id [r], k) ;
+            fragments.tail [s] = fragments.tail [r] ;
+            alive [r] = 0 ;
+            --remaining ;
+            update_after_merge (m, fragments, alive, s, r, fragments [s], fragments [r], false) ;
+            auto tend = std::chrono::high_resolution_clock::now();
+            add_paralel_time (Phase::merge, std::chrono::duration<double>(tend - tstart).count());
+        } else {
+            StringId parent_s = fragments.id [s] ;
+            StringId parent_t = fragments.id [r] ;
+            StringId merged   = fragments.arena.merge (parent_s, parent_t, k) ;
+            Boolean containment = inside [s] || inside [r] ;
+
+            alive [r] = 0 ;
+            slot_of.erase (parent_t) ;
+            slot_of.erase (parent_s) ;
+            fragments.arena.release (parent_t) ;
+            --remaining ;
+
+            // m ja existe no conjunto: o Set descartaria a copia
+            if (slot_of.count (merged)) {
+                alive [s] = 0 ;
+                fragments.arena.release (parent_s) ;
+                fragments.arena.release (merged) ;
+                --remaining ;
+            } else {
+                fragments.id [s] = merged ;
+                fragments.tail [s] = merged ;
+                slot_of [merged] = s ;
+
+                auto tstart = std::chrono::high_resolution_clock::now();
+                update_after_merge (m, fragments, alive, s, r, fragments.arena [parent_s], fragments.arena [parent_t], containment) ;
+                inside [s] = containment && update_containment (fragments, alive, inside, s) ;
+                auto tend = std::chrono::high_resolution_clock::now();
+                add_paralel_time (Phase::merge, std::chrono::duration<double>(tend - tstart).count());
+                fragments.arena.release (parent_s) ;
+            }
+        }
+
+        auto tstart = std::chrono::high_resolution_clock::now();
+        #pragma omp parallel
+        {
+            ThreadClock clock ;
+            #pragma omp for schedule(dynamic) nowait
+            for (ll x = 0; x < (ll) n; ++x) {
+                Size u = (Size) x ;
+                if (! alive [u]) continue ;
+                if (u == s || best [u].column == (ll) s || best [u].column == (ll) r) {
+                    best [u] = best_in_row (m, fragments, alive, u) ;
+                } else if (alive [s]) {
+                    ll value = column_candidate (m, u, s) ;
+                    if ( value >= 0
+                            && better_candidate (fragments, (OverlapSize) value, u, s, best [u].value, u, (Size) best [u].column) ) {
+                        best [u].value = (OverlapSize) value ;
+                        best [u].column = (ll) s ;
+                    }
+                }
+            }
+            clock.stop () ;
+        }
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::reduction, std::chrono::duration<double>(tend - tstart).count());
+
+        if (fragments.arena.needs_compaction ()) fragments.arena.compact (live_ids (fragments, alive)) ;
+        record_iteration (std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - tbegin).count());
+    }
+
+    for (Size i = 0; i < n; ++i) {
+        if (! alive [i]) continue ;
+        return rope ? chain.materialize (fragments.arena, fragments.id [i]) : to_string (fragments [i]) ;
+    }
+    return "" ;
+}
+
+template <typename Cell> inline auto
+incremental_greedy_dense (Fragments& fragments, const Options& options, Boolean rope, std::vector <Merge>* merges) -> String
+{
+    OverlapMatrix <Cell> m = fill_overlap_matrix_for <Cell> (fragments, options) ;
+    return incremental_greedy (fragments, m, rope, merges) ;
+}
+
+// matriz densa com a celula mais estreita que serve, ou esparsa se a densa
+// passar de options.max_memory ou se houver indice de sementes. Com
+// options.drop_contained, t ja passou por drop_contained_strings (como em
+// solve_superstring) e os fragmentos sao cordas.
+inline auto
+shortest_superstring_incremental (const Strings& t, const Options& options = Options (), std::vector <Merge>* merges = nullptr) -> String
+{
+    if (empty (t)) return "" ;
+
+    Boolean rope = options.drop_contained || same_length (t) ;
+    Fragments fragments = fragments_from_strings (t, options.encoding) ;
+    Size n = size (fragments) ;
+    Size cell = cell_bytes_for (fragments) ;
+    if (options.seed != 0 || (options.max_memory != 0 && n * n * cell > options.max_memory)) {
+        std::unique_ptr <SeedIndex> seeds ;
+        if (options.seed != 0) seeds.reset (new SeedIndex (fragments, options.seed)) ;
+        SparseOverlaps m = fill_sparse_overlaps
+            (fragments, seeds.get (), options, sparse_row_capacity (n, options.max_memory)) ;
+        return incremental_greedy (fragments, m, rope, merges) ;
+    }
+    if (cell == 1) return incremental_greedy_dense <std::uint8_t> (fragments, options, rope, merges) ;
+    if (cell == 2) return incremental_greedy_dense <std::uint16_t> (fragments, options, rope, merges) ;
+    return incremental_greedy_dense <std::uint32_t> (fragments, options, rope, merges) ;
+}
+
+// ---------------------------------------------------------------------------
+// Motor de arestas ordenadas: todas as arestas (i, j, ov) com ov > 0 sao
+// geradas uma vez e ordenadas por ov decrescente. A varredura aceita (i, j)
+// se i ainda nao tem sucessor, j nao tem antecessor e os dois estao em
+// caminhos diferentes (union-find). No empate, o laco escolhe o menor par de
+// fragmentos, e o fragmento de um caminho compara como a sua primeira
+// entrada (duas entradas distintas, sem uma conter a outra, diferem antes do
+// fim da menor): a chave de (i, j) e (cabeca do caminho de i, j), e a cabeca
+// muda quando o caminho de i e pendurado em outro. Sem strings contidas, o
+// resultado e o do laco; com elas, o laco recalcula as sobreposicoes dos
+// fragmentos que as contem e os dois podem diferir (--drop-contained os
+// iguala).
+// ---------------------------------------------------------------------------
+
+struct OverlapEdge
+{
+    OverlapSize value ;
+    std::uint32_t from ;
+    std::uint32_t to ;
+} ;
+
+inline auto edge_before (const OverlapEdge& a, const OverlapEdge& b) -> Boolean
+{
+    if (a.value != b.value) return a.value > b.value ;
+    if (a.from != b.from) return a.from < b.from ;
+    return a.to < b.to ;
+}
+
+inline auto find_root (std::vector <Size>& parent, Size x) -> Size
+{
+    while (parent [x] != x) {
+        parent [x] = parent [parent [x]] ;
+        x = parent [x] ;
+    }
+    return x ;
+}
+
+// o que a varredura aceitou: successor [i] = j e joined [i] = ov (i, j)
+struct PathLinks
+{
+    std::vector <ll> successor ;
+    std::vector <OverlapSize> joined ;
+    std::vector <char> has_predecessor ;
+} ;
+
+// edges em ordem de edge_before; os nos 0..n-1 estao em ordem de conteudo.
+// Cada classe de arestas de mesmo valor e varrida por uma fila de caudas
+// livres, pela cabeca do caminho de cada uma; as arestas de uma cauda ja
+// estao em ordem de destino
+inline auto sweep_sorted_edges (Size n, const std::vector <OverlapEdge>& edges) -> PathLinks
+{
+    PathLinks links { std::vector <ll> (n, -1), std::vector <OverlapSize> (n, 0), std::vector <char> (n, 0) } ;
+    std::vector <Size> parent (n), head (n), tail (n) ;
+    for (Size i = 0; i < n; ++i) parent [i] = head [i] = tail [i] = i ;
+
+    struct Run { Size from, next, end ; } ;
+    std::vector <Run> runs ;
+    std::vector <ll> run_of (n, -1) ;
+    using Entry = Pair <Size, Size> ;
+    std::priority_queue <Entry, std::vector <Entry>, std::greater <Entry>> queue ;
+    Size accepted = 0 ;
+
+    for (Size lo = 0; lo < size (edges) && accepted + 1 < n; ) {
+        Size hi = lo ;
+        runs.clear () ;
+        while (hi < size (edges) && edges [hi].value == edges [lo].value) {
+            Size end = hi ;
+            while (end < size (edges) && edges [end].value == edges [lo].value && edges [end].from == edges [hi].from) ++end ;
+            Size u = edges [hi].from ;
+            if (links.successor [u] < 0) {
+                run_of [u] = (ll) size (runs) ;
+                queue.push (Entry { head [find_root (parent, u)], size (runs) }) ;
+                runs.push_back (Run { u, hi, end }) ;
+            }
+            hi = end ;
+        }
+
+        while (! empty (queue)) {
+            Entry top = queue.top () ;
+            queue.pop () ;
+            Run& run = runs [top.second] ;
+            Size a = find_root (parent, run.from) ;
+            // a cauda ja saiu, ou o caminho dela ganhou outra cabeca
+            if (links.successor [run.from] >= 0 || head [a] != top.first) continue ;
+            while (run.next < run.end
+                    && ( links.has_predecessor [edges [run.next].to]
+                        || find_root (parent, edges [run.next].to) == a ) )
+                ++run.next ;
+            if (run.next == run.end) continue ;
+
+            const OverlapEdge& e = edges [run.next] ;
+            Size b = find_root (parent, e.to) ;
+            parent [b] = a ;
+            tail [a] = tail [b] ;
+            links.successor [e.from] = (ll) e.to ;
+            links.joined [e.from] = e.value ;
+            links.has_predecessor [e.to] = 1 ;
+            ++accepted ;
+            if (run_of [tail [a]] >= 0) queue.push (Entry { head [a], (Size) run_of [tail [a]] }) ;
+        }
+        for (const Run& run : runs) run_of [run.from] = -1 ;
+        lo = hi ;
+    }
+    return links ;
+}
+
+template <typename Cell> inline auto
+sorted_edges_greedy (const Fragments& fragments, const Options& options) -> String
+{
+    Size n = size (fragments) ;
+    OverlapMatrix <Cell> m = fill_overlap_matrix_for <Cell> (fragments, options) ;
+
+    auto tstart = std::chrono::high_resolution_clock::now();
+    std::vector <OverlapEdge> edges ;
+    #pragma omp parallel
+    {
+        ThreadClock clock ;
+        std::vector <OverlapEdge> local ;
+        #pragma omp for schedule(dynamic) nowait
+        for (ll i = 0; i < (ll) n; ++i) {
+            for (Size j = 0; j < n; ++j) {
+                if ((Size) i == j) continue ;
+                OverlapSize value = m.at ((Size) i, j) ;
+                if (value > 0) local.push_back (OverlapEdge { value, (std::uint32_t) i, (std::uint32_t) j }) ;
+            }
+        }
+        clock.stop () ;
+        #pragma omp critical
+        edges.insert (edges.end (), local.begin (), local.end ()) ;
+    }
+    parallel_sort (edges, edge_before) ;
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::pairs, std::chrono::duration<double>(tend - tstart).count());
+
+    tstart = std::chrono::high_resolution_clock::now();
+    PathLinks links = sweep_sorted_edges (n, edges) ;
+
+    // cada caminho vira um fragmento; sem sobreposicao entre eles, o laco
+    // original os juntaria do menor para o maior
+    std::vector <String> paths ;
+    for (Size i = 0; i < n; ++i) {
+        if (links.has_predecessor [i]) continue ;
+        String x = to_string (fragments [i]) ;
+        for (Size u = i; links.successor [u] >= 0; u = (Size) links.successor [u])
+            x += remove_prefix (to_string (fragments [(Size) links.successor [u]]), links.joined [u]) ;
+        paths.push_back (x) ;
+    }
+    std::sort (paths.begin (), paths.end ()) ;
+
+    String x = paths [0] ;
+    for (Size i = 1; i < size (paths); ++i) x = overlap (x, paths [i]) ;
+    tend = std::chrono::high_resolution_clock::now();
+    add_phase_time (Phase::merge, std::chrono::duration<double>(tend - tstart).count());
+    return x ;
+}
+
+// todas as arestas positivas sao necessarias, entao so a matriz densa serve
+inline auto
+shortest_superstring_sorted_edges (const Strings& t, const Options& options = Options ()) -> String
+{
+    if (empty (t)) return "" ;
+
+    Fragments fragments = fragments_from_strings (t, options.encoding) ;
+    Size cell = cell_bytes_for (fragments) ;
+    if (cell == 1) return sorted_edges_greedy <std::uint8_t> (fragments, options) ;
+    if (cell == 2) return sorted_edges_greedy <std::uint16_t> (fragments, options) ;
+    return sorted_edges_greedy <std::uint32_t> (fragments, options) ;
+}
+
+// ---------------------------------------------------------------------------
+// Motor exato: o guloso e so uma aproximacao. Sem strings contidas, a menor
+// superstring e o caminho hamiltoniano de maior sobreposicao total. Ate
+// held_karp_strings strings usa a DP de Held-Karp sobre subconjuntos,
+// paralela por camada (subconjuntos com o mesmo numero de bits so dependem
+// da camada anterior). Acima disso, branch-and-bound com o resultado do
+// guloso como primeiro limite e as subarvores (i, j, k) distribuidas pelo
+// escalonador com roubo de trabalho; com so as (i, j), uma subarvore funda
+// ficava toda com uma thread. A busca para em options.exact_budget
+// segundos, e entao o resultado nao tem prova de otimo.
+// ---------------------------------------------------------------------------
+
+static const Size held_karp_strings = 20 ;
+
+inline auto path_string (const Fragments& fragments, const OverlapMatrix <std::uint32_t>& m, const std::vector <Size>& path) -> String
+{
+    String x = to_string (fragments [path [0]]) ;
+    for (Size k = 1; k < size (path); ++k) {
+        StringView next = fragments [path [k]] ;
+        OverlapSize ov = m.at (path [k - 1], path [k]) ;
+        x.append (next.data + ov, next.length - ov) ;
+    }
+    return x ;
+}
+
+inline auto held_karp_path (const OverlapMatrix <std::uint32_t>& m) -> std::vector <Size>
+{
+    Size n = m.n ;
+    Size subsets = Size (1) << n ;
+    std::vector <std::uint32_t> best (subsets * n, 0) ;
+
+    auto tstart = std::chrono::high_resolution_clock::now();
+    // subconjuntos agrupados por numero de bits (contagem), para cada camada
+    // percorrer so os seus
+    std::vector <Size> first (n + 2, 0) ;
+    for (Size mask = 0; mask < subsets; ++mask) ++first [(Size) __builtin_popcountll (mask) + 1] ;
+    for (Size layer = 1; layer <= n + 1; ++layer) first [layer] += first [layer - 1] ;
+    std::vector <std::uint32_t> by_layer (subsets) ;
+    std::vector <Size> next (first.begin (), first.end () - 1) ;
+    for (Size mask = 0; mask < subsets; ++mask) by_layer [next [(Size) __builtin_popcountll (mask)]++] = (std::uint32_t) mask ;
+
+    for (Size layer = 2; layer <= n; ++layer) {
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (ll x = (ll) first [layer]; x < (ll) first [layer + 1]; ++x) {
+            Size mask = by_layer [(Size) x] ;
+            for (Size j = 0; j < n; ++j) {
+                if (! (mask >> j & 1)) continue ;
+                Size rest = mask ^ (Size (1) << j) ;
+                std::uint32_t value = 0 ;
+                for (Size i = 0; i < n; ++i)
+                    if (rest >> i & 1) value = std::max (value, best [rest * n + i] + (std::uint32_t) m.at (i, j)) ;
+                best [mask * n + j] = value ;
+            }
+        }
+    }
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::search, std::chrono::duration<double>(tend - tstart).count());
+
+    // refaz o caminho de tras para frente, sempre com o menor indice
+    std::vector <Size> path (n) ;
+    Size mask = subsets - 1 ;
+    Size last = 0 ;
+    for (Size j = 1; j < n; ++j) if (best [mask * n + j] > best [mask * n + last]) last = j ;
+    for (Size k = n; k-- > 0; ) {
+        path [k] = last ;
+        Size rest = mask ^ (Size (1) << last) ;
+        for (Size i = 0; i < n && rest != 0; ++i) {
+            if ((rest >> i & 1) && best [rest * n + i] + m.at (i, last) == best [mask * n + last]) {
+                last = i ;
+                break ;
+            }
+        }
+        mask = rest ;
+    }
+    return path ;
+}
+
+// nos da busca entre duas leituras do relogio
+static const Size clock_nodes = 1024 ;
+
+// limite da sobreposicao que falta: cada string fora do caminho recebe uma
+// aresta de entrada, e o fim do caminho e cada uma delas dao no maximo uma
+// de saida
+class PathSearch
+{
+public:
+    PathSearch (const Fragments& fragments, const OverlapMatrix <std::uint32_t>& m, Size incumbent, double seconds)
+        : fragments (fragments), m (m), n (m.n), best_in (n, 0), best_out (n, 0)
+        , deadline (std::chrono::steady_clock::now () + std::chrono::duration <double> (seconds))
+        , stopped (false), best_length (incumbent)
+    {
+        for (Size i = 0; i < n; ++i) {
+            for (Size j = 0; j < n; ++j) {
+                if (i == j) continue ;
+                best_out [i] = std::max <OverlapSize> (best_out [i], m.at (i, j)) ;
+                best_in [j] = std::max <OverlapSize> (best_in [j], m.at (i, j)) ;
+            }
+        }
+    }
+
+    auto search () -> void
+    {
+        auto tstart = std::chrono::high_resolution_clock::now();
+        // linha i n + j, coluna k: a subarvore que comeca por i, j, k
+        for_each_tile_stealing ((ll) (n * n), (ll) n, [&] (const Tile& t, Size) {
+            for (ll p = t.row_begin; p < t.row_end; ++p)
+                for (ll k = t.column_begin; k < t.column_end; ++k)
+                    search_from ((Size) p / n, (Size) p % n, (Size) k) ;
+        }) ;
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::search, std::chrono::duration<double>(tend - tstart).count());
+    }
+
+    // vazio se nada bateu o limite inicial
+    auto path () const -> const std::vector <Size>& { return best_path ; }
+
+    // o prazo acabou antes de a arvore ser toda podada ou percorrida
+    auto exhausted () const -> Boolean { return stopped.load () ; }
+
+private:
+    struct State
+    {
+        std::vector <Size> path ;
+        std::vector <char> placed ;
+        Size length ;
+        Size unplaced_length ;
+        Size unplaced_in ;
+        Size unplaced_out ;
+        Size nodes ;
+    } ;
+
+    auto place (State& x, Size j) const -> void
+    {
+        x.path.push_back (j) ;
+        x.placed [j] = 1 ;
+        x.unplaced_length -= fragments [j].length ;
+        x.unplaced_in -= best_in [j] ;
+        x.unplaced_out -= best_out [j] ;
+    }
+
+    auto unplace (State& x, Size j) const -> void
+    {
+        x.path.pop_back () ;
+        x.placed [j] = 0 ;
+        x.unplaced_length += fragments [j].length ;
+        x.unplaced_in += best_in [j] ;
+        x.unplaced_out += best_out [j] ;
+    }
+
+    // limite inferior do comprimento de qualquer caminho que estenda x
+    auto bound (const State& x) const -> Size
+    {
+        Size gain = std::min (x.unplaced_in, best_out [x.path.back ()] + x.unplaced_out) ;
+        return x.length + x.unplaced_length - std::min (gain, x.unplaced_length) ;
+    }
+
+    // o relogio custa tanto quanto um no
+    auto out_of_time (State& x) -> Boolean
+    {
+        if (stopped.load (std::memory_order_relaxed)) return true ;
+        if (++x.nodes % clock_nodes != 0 || std::chrono::steady_clock::now () < deadline) return false ;
+        stopped.store (true) ;
+        return true ;
+    }
+
+    auto search_from (Size i, Size j, Size k) -> void
+    {
+        if (i == j || k == i || k == j || stopped.load (std::memory_order_relaxed)) return ;
+        State x { {}, std::vector <char> (n, 0), 0, 0, 0, 0, 0 } ;
+        for (Size u = 0; u < n; ++u) {
+            x.unplaced_length += fragments [u].length ;
+            x.unplaced_in += best_in [u] ;
+            x.unplaced_out += best_out [u] ;
+        }
+        place (x, i) ;
+        x.length = fragments [i].length ;
+        place (x, j) ;
+        x.length += fragments [j].length - m.at (i, j) ;
+        if (bound (x) >= best_length.load (std::memory_order_relaxed)) return ;
+        place (x, k) ;
+        x.length += fragments [k].length - m.at (j, k) ;
+        extend (x) ;
+    }
+
+    auto extend (State& x) -> void
+    {
+        Size last = x.path.back () ;
+        if (size (x.path) == n) {
+            std::lock_guard <std::mutex> lock (mutex) ;
+            if (x.length < best_length.load ()) {
+                best_length.store (x.length) ;
+                best_path = x.path ;
+            }
+            return ;
+        }
+        if (bound (x) >= best_length.load (std::memory_order_relaxed) || out_of_time (x)) return ;
+
+        std::vector <Size> next ;
+        for (Size j = 0; j < n; ++j) if (! x.placed [j]) next.push_back (j) ;
+        std::stable_sort (next.begin (), next.end (), [&] (Size a, Size b) { return m.at (last, a) > m.at (last, b) ; }) ;
+        for (Size j : next) {
+            Size added = fragments [j].length - m.at (last, j) ;
+            place (x, j) ;
+            x.length += added ;
+            extend (x) ;
+            x.length -= added ;
+            unplace (x, j) ;
+        }
+    }
+
+    const Fragments& fragments ;
+    const OverlapMatrix <std::uint32_t>& m ;
+    Size n ;
+    std::vector <OverlapSize> best_in ;
+    std::vector <OverlapSize> best_out ;
+    std::chrono::time_point <std::chrono::steady_clock, std::chrono::duration <double>> deadline ;
+    std::atomic <Boolean> stopped ;
+    std::atomic <Size> best_length ;
+    std::mutex mutex ;
+    std::vector <Size> best_path ;
+} ;
+
+// *exhausted: a busca parou no prazo, sem provar que o resultado e otimo
+inline auto
+shortest_superstring_exact (const Strings& t, const Options& options = Options (), Boolean* exhausted = nullptr) -> String
+{
+    Strings kept = t ;
+    drop_contained_strings (kept) ;
+    if (size (kept) < 2) return empty (kept) ? "" : to_string (kept [0]) ;
+
+    Fragments fragments = fragments_from_strings (kept, options.encoding) ;
+    OverlapMatrix <std::uint32_t> m = fill_overlap_matrix_for <std::uint32_t> (fragments, options) ;
+    if (size (fragments) <= held_karp_strings) return path_string (fragments, m, held_karp_path (m)) ;
+
+    String greedy = shortest_superstring_incremental (kept, options) ;
+    PathSearch search (fragments, m, size (greedy), options.exact_budget) ;
+    search.search () ;
+    if (exhausted) *exhausted = search.exhausted () ;
+    return empty (search.path ()) ? greedy : path_string (fragments, m, search.path ()) ;
+}
+
+// ---------------------------------------------------------------------------
+// Busca local (--local-search=segundos): sem strings contidas, ordenar as
+// strings pela primeira ocorrencia numa superstring da um caminho cuja
+// superstring nao e maior que ela. A partir do caminho do guloso, cada
+// rodada avalia em paralelo todos os movimentos e aplica o de maior ganho
+// de sobreposicao: inverter um trecho (2-opt) e mover um trecho de ate tres
+// strings, invertido ou nao, para outro ponto (Or-opt). Com somas de
+// prefixo das sobreposicoes nos dois sentidos, o ganho de inverter um
+// trecho sai em O(1). Para quando nao ha ganho ou o tempo acaba.
+// ---------------------------------------------------------------------------
+
+static const ll or_opt_length = 3 ;
+
+// alvo de um 2-opt: o trecho e invertido no lugar
+static const ll in_place = -2 ;
+
+struct PathMove
+{
+    ll gain ;
+    ll begin ;
+    ll end ;
+    ll target ;
+    Boolean reversed ;
+} ;
+
+inline auto no_move () -> PathMove { return PathMove { 0, -1, -1, in_place, false } ; }
+
+inline auto better_move (const PathMove& a, const PathMove& b) -> PathMove
+{
+    if (a.gain != b.gain) return a.gain > b.gain ? a : b ;
+    if (a.begin != b.begin) return a.begin < b.begin ? a : b ;
+    if (a.end != b.end) return a.end < b.end ? a : b ;
+    if (a.target != b.target) return a.target < b.target ? a : b ;
+    return a.reversed ? b : a ;
+}
+
+#pragma omp declare reduction (best_move : PathMove : omp_out = better_move (omp_out, omp_in)) \
+    initializer (omp_priv = no_move ())
+
+// caminho pela primeira ocorrencia de cada string (sorted, sem contidas) em x
+inline auto path_by_first_occurrence (const Strings& sorted, const String& x) -> std::vector <Size>
+{
+    OverlapAutomaton automaton (sorted) ;
+    Size n = size (sorted) ;
+    std::vector <Size> start (n, std::numeric_limits <Size>::max ()) ;
+    int state = 0 ;
+    for (Size p = 0; p < size (x); ++p) {
+        state = automaton.next (state, x [p]) ;
+        const OverlapAutomaton::Node& v = automaton.nodes [state] ;
+        for (int u = v.word >= 0 ? state : v.output; u >= 0; u = automaton.nodes [u].output) {
+            Size j = (Size) automaton.nodes [u].word ;
+            start [j] = std::min (start [j], p + 1 - sorted [j].length) ;
+        }
+    }
+    std::vector <Size> path (n) ;
+    for (Size j = 0; j < n; ++j) path [j] = j ;
+    std::stable_sort (path.begin (), path.end (), [&] (Size a, Size b) { return start [a] < start [b] ; }) ;
+    return path ;
+}
+
+class PathImprover
+{
+public:
+    PathImprover (const OverlapMatrix <std::uint32_t>& m, std::vector <Size>& path)
+        : m (m), path (path), n ((ll) size (path)), forward (size (path)), backward (size (path)) {}
+
+    auto improve (double seconds) -> void
+    {
+        auto deadline = std::chrono::steady_clock::now () + std::chrono::duration <double> (seconds) ;
+        while (std::chrono::steady_clock::now () < deadline) {
+            prefix_sums () ;
+            auto tstart = std::chrono::high_resolution_clock::now();
+            PathMove best = best_move () ;
+            auto tend = std::chrono::high_resolution_clock::now();
+            add_paralel_time (Phase::search, std::chrono::duration<double>(tend - tstart).count());
+            if (best.gain <= 0) return ;
+            apply (best) ;
+        }
+    }
+
+private:
+    // sobreposicao entre posicoes; -1 e n sao as pontas vazias
+    auto ov (ll a, ll b) const -> ll
+    {
+        if (a < 0 || b < 0 || a >= n || b >= n) return 0 ;
+        return (ll) m.at (path [(Size) a], path [(Size) b]) ;
+    }
+
+    auto prefix_sums () -> void
+    {
+        forward [0] = backward [0] = 0 ;
+        for (ll k = 1; k < n; ++k) {
+            forward [(Size) k] = forward [(Size) k - 1] + ov (k - 1, k) ;
+            backward [(Size) k] = backward [(Size) k - 1] + ov (k, k - 1) ;
+        }
+    }
+
+    // trecho [begin, end] lido ao contrario
+    auto reversal_gain (ll begin, ll end) const -> ll
+    {
+        return (backward [(Size) end] - backward [(Size) begin]) - (forward [(Size) end] - forward [(Size) begin]) ;
+    }
+
+    auto two_opt_gain (ll begin, ll end) const -> ll
+    {
+        return ov (begin - 1, end) + ov (begin, end + 1) - ov (begin - 1, begin) - ov (end, end + 1)
+            + reversal_gain (begin, end) ;
+    }
+
+    // trecho [begin, end] sai do lugar e entra entre target e target + 1
+    auto or_opt_gain (ll begin, ll end, ll target, Boolean reversed) const -> ll
+    {
+        ll first = reversed ? end : begin ;
+        ll last  = reversed ? begin : end ;
+        ll removed = ov (begin - 1, end + 1) - ov (begin - 1, begin) - ov (end, end + 1) ;
+        ll before = target < 0 ? -1 : target ;
+        ll after  = target + 1 >= n ? n : target + 1 ;
+        ll inserted = ov (before, first) + ov (last, after) - ov (before, after) ;
+        return removed + inserted + (reversed ? reversal_gain (begin, end) : 0) ;
+    }
+
+    auto best_move () const -> PathMove
+    {
+        PathMove best = no_move () ;
+        #pragma omp parallel for schedule(dynamic) reduction(best_move : best)
+        for (ll begin = 0; begin < n; ++begin) {
+            for (ll end = begin + 1; end < n; ++end) {
+                best = better_move (best, PathMove { two_opt_gain (begin, end), begin, end, in_place, true }) ;
+            }
+            for (ll end = begin; end < std::min (n, begin + or_opt_length); ++end) {
+                for (ll target = -1; target < n; ++target) {
+                    if (target >= begin - 1 && target <= end) continue ;
+                    best = better_move (best, PathMove { or_opt_gain (begin, end, target, false), begin, end, target, false }) ;
+                    if (end > begin)
+                        best = better_move (best, PathMove { or_opt_gain (begin, end, target, true), begin, end, target, true }) ;
+                }
+            }
+        }
+        return best ;
+    }
+
+    auto apply (const PathMove& move) -> void
+    {
+        auto first = path.begin () + move.begin ;
+        auto last  = path.begin () + move.end + 1 ;
+        if (move.target == in_place) {
+            std::reverse (first, last) ;
+            return ;
+        }
+        std::vector <Size> segment (first, last) ;
+        if (move.reversed) std::reverse (segment.begin (), segment.end ()) ;
+        path.erase (first, last) ;
+        ll target = move.target < move.begin ? move.target + 1 : move.target + 1 - (ll) size (segment) ;
+        path.insert (path.begin () + target, segment.begin (), segment.end ()) ;
+    }
+
+    const OverlapMatrix <std::uint32_t>& m ;
+    std::vector <Size>& path ;
+    ll n ;
+    std::vector <ll> forward ;
+    std::vector <ll> backward ;
+} ;
+
+// devolve x ou a superstring do caminho melhorado, a menor
+inline auto improve_by_local_search (const Strings& t, const String& x, const Options& options) -> String
+{
+    Strings kept = t ;
+    drop_contained_strings (kept) ;
+    if (size (kept) < 3) return x ;
+
+    Fragments fragments = fragments_from_strings (kept, options.encoding) ;
+    OverlapMatrix <std::uint32_t> m = fill_overlap_matrix_for <std::uint32_t> (fragments, options) ;
+    std::vector <Size> path = path_by_first_occurrence (kept, x) ;
+    PathImprover (m, path).improve (options.local_search) ;
+
+    String y = path_string (fragments, m, path) ;
+    return size (y) < size (x) ? y : x ;
+}
+
+inline auto write_string_and_break_line (OutStream& out, String s) -> void 
+{ 
+    out << s << std::endl; 
+}
+
+inline auto read_size (InStream& in) -> Size 
+{ 
+    Size n; 
+    in >> n; 
+    return n; 
+}
+
+inline auto read_string (InStream& in) -> String { 
+    String s; 
+    in >> s; 
+    return s; 
+}
+
+inline auto read_strings_from_standard_input () -> Set <String>
+{
+    using N = SizeType <Set <String>>;
+    Set <String> x;
+    N n = N (read_size (standard_input));
+    while (n--) x.insert (read_string (standard_input));
+    return x;
+}
+
+// ---------------------------------------------------------------------------
+// Leitura sem copia: a entrada padrao e mapeada na memoria quando e um
+// arquivo, ou lida em blocos grandes quando e um pipe. As strings viram
+// views sobre esse buffer e as repetidas saem com um sort paralelo seguido
+// de unique, sem passar por um Set <String>.
+// ---------------------------------------------------------------------------
+
+class InputBuffer
+{
+public:
+    InputBuffer () = default ;
+    InputBuffer (const InputBuffer&) = delete ;
+    auto operator= (const InputBuffer&) -> InputBuffer& = delete ;
+
+    ~InputBuffer ()
+    {
+        if (mapping != nullptr) munmap (mapping, mapped_length) ;
+    }
+
+    auto load (int fd) -> Boolean
+    {
+        struct stat info ;
+        off_t offset = lseek (fd, 0, SEEK_CUR) ;
+        if (fstat (fd, &info) == 0 && S_ISREG (info.st_mode) && offset >= 0 && info.st_size > offset) {
+            mapped_length = (Size) info.st_size ;
+            mapping = mmap (nullptr, mapped_length, PROT_READ, MAP_PRIVATE, fd, 0) ;
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr ;
+                return false ;
+            }
+            madvise (mapping, mapped_length, MADV_SEQUENTIAL) ;
+            data = (const char*) mapping + offset ;
+            length = mapped_length - (Size) offset ;
+            return true ;
+        }
+
+        const Size block = Size (1) << 22 ;
+        for (;;) {
+            Size at = size (storage) ;
+            storage.resize (at + block) ;
+            ssize_t got = read (fd, storage.data () + at, block) ;
+            if (got < 0) return false ;
+            storage.resize (at + (Size) got) ;
+            if (got == 0) break ;
+        }
+        data = storage.data () ;
+        length = size (storage) ;
+        return true ;
+    }
+
+    // buffer proprio de length bytes, para receber a entrada de outro processo
+    auto allocate (Size bytes) -> char*
+    {
+        storage.resize (bytes) ;
+        data = storage.data () ;
+        length = bytes ;
+        return storage.data () ;
+    }
+
+    const char* data = nullptr ;
+    Size length = 0 ;
+
+private:
+    void* mapping = nullptr ;
+    Size mapped_length = 0 ;
+    std::vector <char> storage ;
+} ;
+
+// no build MPI so o processo 0 le a entrada padrao e a difunde aos outros
+inline auto load_standard_input (InputBuffer& in) -> Boolean
+{
+#ifdef SHSUP_MPI
+    long long length = 0 ;
+    if (ranks ().rank == 0) length = in.load (0) ? (long long) in.length : -1 ;
+    MPI_Bcast (&length, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD) ;
+    if (length < 0) return false ;
+    char* data = ranks ().rank == 0 ? const_cast <char*> (in.data) : in.allocate ((Size) length) ;
+    const long long chunk = 1ll << 30 ;
+    for (long long at = 0; at < length; at += chunk)
+        MPI_Bcast (data + at, (int) std::min (chunk, length - at), MPI_CHAR, 0, MPI_COMM_WORLD) ;
+    return true ;
+#else
+    return in.load (0) ;
+#endif
+}
+
+inline auto is_space (char c) -> Boolean
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f' ;
+}
+
+// mesmo formato de read_strings_from_standard_input: n e depois n palavras
+inline auto parse_strings (const char*& p, const char* end) -> Strings
+{
+    while (p != end && is_space (*p)) ++p ;
+    Size n = 0 ;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p) n = 10 * n + (Size) (*p - '0') ;
+
+    Strings x ;
+    x.reserve (std::min (n, (Size) (end - p) / 2 + 1)) ;
+    Size count = 0 ;
+    for (; count < n; ++count) {
+        while (p != end && is_space (*p)) ++p ;
+        if (p == end) break ;
+        const char* start = p ;
+        while (p != end && ! is_space (*p)) ++p ;
+        x.push_back (StringView { start, (Size) (p - start) }) ;
+    }
+    // operator>> sem nada para ler deixa a string vazia
+    if (count < n) x.push_back (StringView { p, 0 }) ;
+    return x ;
+}
+
+inline auto sort_and_remove_repeated (Strings& x) -> void
+{
+    auto tstart = std::chrono::high_resolution_clock::now();
+    parallel_sort (x, [] (StringView a, StringView b) { return a < b ; }) ;
+    x.erase (std::unique (x.begin (), x.end ()), x.end ()) ;
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (std::chrono::duration<double>(tend - tstart).count());
+}
+
+inline auto read_strings_from_buffer (const InputBuffer& in) -> Strings
+{
+    const char* p = in.data ;
+    Strings x = parse_strings (p, in.data + in.length) ;
+    sort_and_remove_repeated (x) ;
+    return x ;
+}
+
+// ---------------------------------------------------------------------------
+// Leitura em pipeline (--reader=pipeline, motor incremental): uma thread
+// produtora le a entrada padrao em blocos de pipeline_block bytes e separa
+// as strings, enquanto as threads do OpenMP poem as de cada bloco na arena
+// e calculam as sobreposicoes delas contra as ja carregadas (a linha e a
+// coluna de cada nova). Quando o ultimo byte chega, so falta o ultimo bloco
+// para a matriz ficar pronta e o guloso comecar. As repetidas saem por hash
+// do conteudo; no fim as posicoes sao ordenadas pelo conteudo e a matriz e
+// permutada uma vez, sem recalcular nada.
+// ---------------------------------------------------------------------------
+
+static const Size pipeline_block = Size (1) << 22 ;
+
+// strings inteiras de um bloco; as views apontam para text
+struct InputBlock
+{
+    String text ;
+    Strings strings ;
+} ;
+
+class BlockQueue
+{
+public:
+    auto push (std::unique_ptr <InputBlock> block) -> void
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex) ;
+            blocks.push_back (std::move (block)) ;
+        }
+        ready.notify_one () ;
+    }
+
+    auto close () -> void
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex) ;
+            closed = true ;
+        }
+        ready.notify_one () ;
+    }
+
+    // nullptr depois do ultimo bloco
+    auto pop () -> std::unique_ptr <InputBlock>
+    {
+        std::unique_lock <std::mutex> lock (mutex) ;
+        ready.wait (lock, [this] { return closed || ! blocks.empty () ; }) ;
+        if (blocks.empty ()) return nullptr ;
+        std::unique_ptr <InputBlock> block = std::move (blocks.front ()) ;
+        blocks.pop_front () ;
+        return block ;
+    }
+
+private:
+    std::mutex mutex ;
+    std::condition_variable ready ;
+    std::deque <std::unique_ptr <InputBlock>> blocks ;
+    Boolean closed = false ;
+} ;
+
+// mesmo formato de parse_strings; a palavra cortada no fim de um bloco
+// passa para o seguinte
+inline auto produce_blocks (int fd, BlockQueue& queue, Boolean& failed, double& seconds) -> void
+{
+    auto tstart = std::chrono::high_resolution_clock::now();
+    std::vector <char> buffer (pipeline_block) ;
+    String carry ;
+    Boolean counted = false ;
+    Size n = 0 ;
+    Size count = 0 ;
+    for (;;) {
+        ssize_t got = read (fd, buffer.data (), size (buffer)) ;
+        if (got < 0) {
+            failed = true ;
+            break ;
+        }
+        std::unique_ptr <InputBlock> block (new InputBlock) ;
+        block->text.swap (carry) ;
+        block->text.append (buffer.data (), (Size) got) ;
+        if (got > 0) {
+            Size complete = size (block->text) ;
+            while (complete > 0 && ! is_space (block->text [complete - 1])) --complete ;
+            carry.assign (block->text, complete, String::npos) ;
+            block->text.resize (complete) ;
+        }
+
+        const char* p = block->text.data () ;
+        const char* end = p + size (block->text) ;
+        if (! counted) {
+            while (p != end && is_space (*p)) ++p ;
+            counted = p != end || got == 0 ;
+            for (; p != end && *p >= '0' && *p <= '9'; ++p) n = 10 * n + (Size) (*p - '0') ;
+        }
+        for (; counted && count < n; ++count) {
+            while (p != end && is_space (*p)) ++p ;
+            if (p == end) break ;
+            const char* start = p ;
+            while (p != end && ! is_space (*p)) ++p ;
+            block->strings.push_back (StringView { start, (Size) (p - start) }) ;
+        }
+        // operator>> sem nada para ler deixa a string vazia
+        if (got == 0 && count < n) {
+            block->strings.push_back (StringView { end, 0 }) ;
+            count = n ;
+        }
+        if (! empty (block->strings)) queue.push (std::move (block)) ;
+        if (got == 0 || (counted && count == n)) break ;
+    }
+    queue.close () ;
+    seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - tstart).count();
+}
+
+template <typename Cell> inline auto
+pipelined_incremental (BlockQueue& queue, std::unique_ptr <InputBlock> block, const Options& options) -> String
+{
+    Fragments fragments ;
+    OverlapMatrix <Cell> m (fragments) ;
+    std::unordered_set <StringId, ContentHash, ContentEqual> seen
+        ( 0, ContentHash { &fragments.arena }, ContentEqual { &fragments.arena } ) ;
+    Boolean uniform = true ;
+
+    for (; block; block = queue.pop ()) {
+        Size first = size (fragments) ;
+        for (StringView x : block->strings) {
+            StringId id = fragments.arena.add (x) ;
+            if (! seen.insert (id).second) {
+                fragments.arena.release (id) ;
+                continue ;
+            }
+            uniform = uniform && (empty (fragments.id) || x.length == fragments [0].length) ;
+            fragments.id.push_back (id) ;
+            fragments.tail.push_back (id) ;
+        }
+        block.reset () ;
+        Size count = size (fragments) ;
+        if (count > m.n) {
+            std::vector <Size> same (first) ;
+            for (Size i = 0; i < first; ++i) same [i] = i ;
+            m.reorder (same, std::max (count, 2 * m.n)) ;
+        }
+
+        // linhas novas inteiras e o trecho novo das linhas antigas, com o
+        // escalonador e os blocos de fill_overlap_matrix
+        auto tstart = std::chrono::high_resolution_clock::now();
+        Size tile = tile_size_for (options.tile, count, size (fragments.arena.bytes)) ;
+        auto cell = [&] (ll i, ll j) {
+            if (i != j && ((Size) i >= first || (Size) j >= first))
+                m.set ((Size) i, (Size) j, fragments.overlap ((Size) i, (Size) j)) ;
+        } ;
+        if (options.scheduler == Scheduler::stealing) {
+            ll old = (ll) first ;
+            ll added = (ll) (count - first) ;
+            for_each_tile_stealing (added, (ll) count, [&] (const Tile& t, Size) {
+                for_each_cell_blocked (Tile { t.row_begin + old, t.row_end + old, t.column_begin, t.column_end }, tile, cell) ;
+            }) ;
+            for_each_tile_stealing (old, added, [&] (const Tile& t, Size) {
+                for_each_cell_blocked (Tile { t.row_begin, t.row_end, t.column_begin + old, t.column_end + old }, tile, cell) ;
+            }) ;
+        } else {
+            // tile = 0: uma linha por vez
+            Size step = tile == 0 ? 1 : tile ;
+            std::vector <Tile> tiles ;
+            for (Size ib = 0; ib < count; ib += step) {
+                Size ie = std::min (ib + step, count) ;
+                if (tile == 0) {
+                    tiles.push_back (Tile { (ll) ib, (ll) ie, (ll) (ib < first ? first : 0), (ll) count }) ;
+                    continue ;
+                }
+                for (Size jb = ie <= first ? first : 0; jb < count; jb += tile) {
+                    tiles.push_back (Tile { (ll) ib, (ll) ie, (ll) jb, (ll) std::min (jb + tile, count) }) ;
+                }
+            }
+            #pragma omp parallel
+            {
+                ThreadClock clock ;
+                #pragma omp for schedule(dynamic) nowait
+                for (ll k = 0; k < (ll) size (tiles); ++k) for_each_cell_blocked (tiles [(Size) k], tile, cell) ;
+                clock.stop () ;
+            }
+        }
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+    }
+
+    if (empty (fragments.id)) return "" ;
+
+    // posicoes em ordem de conteudo, como nos outros leitores: o resultado
+    // seria o mesmo, mas os desempates do guloso saem mais baratos
+    auto tstart = std::chrono::high_resolution_clock::now();
+    std::vector <Size> order (size (fragments)) ;
+    for (Size i = 0; i < size (order); ++i) order [i] = i ;
+    parallel_sort (order, [&fragments] (Size a, Size b) { return fragments [a] < fragments [b] ; }) ;
+    std::vector <StringId> sorted ;
+    for (Size i : order) sorted.push_back (fragments.id [i]) ;
+    fragments.id = sorted ;
+    fragments.tail = sorted ;
+    m.reorder (order, size (order)) ;
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
+    return incremental_greedy (fragments, m, uniform, nullptr) ;
+}
+
+// le fd ate o fim e devolve a superstring do motor incremental; as celulas
+// sao escolhidas pelo primeiro bloco, e valores que nao cabem nelas sao
+// recalculados na leitura. De options so valem scheduler e tile; o resto
+// (encoding, max_memory, sementes, pre-filtro) fica para parse_options
+// recusar
+inline auto shortest_superstring_pipelined (int fd, const Options& options, String& superstring) -> Boolean
+{
+    BlockQueue queue ;
+    Boolean failed = false ;
+    double reading = 0.0 ;
+    std::thread producer (produce_blocks, fd, std::ref (queue), std::ref (failed), std::ref (reading)) ;
+
+    std::unique_ptr <InputBlock> block = queue.pop () ;
+    Size longest = 0 ;
+    if (block) for (StringView x : block->strings) longest = std::max (longest, x.length) ;
+    if (longest < std::numeric_limits <std::uint8_t>::max ()) superstring = pipelined_incremental <std::uint8_t> (queue, std::move (block), options) ;
+    else if (longest < std::numeric_limits <std::uint16_t>::max ()) superstring = pipelined_incremental <std::uint16_t> (queue, std::move (block), options) ;
+    else superstring = pipelined_incremental <std::uint32_t> (queue, std::move (block), options) ;
+
+    producer.join () ;
+    add_phase_time (Phase::input, reading) ;
+    return ! failed ;
+}
+
+// ---------------------------------------------------------------------------
+// Modo online (--state=arquivo): os dados chegam em lotes. O estado sao os
+// caminhos que sobram da varredura de arestas ordenadas, ja juntados em
+// fragmentos e mantidos em ordem. Cada lote so grava as fusoes com
+// sobreposicao >= min_overlap: as fracas (as de 1 ou 2 caracteres que sobram
+// no fim da varredura) ocupariam pontas que um lote seguinte pode querer
+// para uma fusao forte. Entao entre dois fragmentos nao ha sobreposicao >=
+// min_overlap (salvo strings contidas), essa parte da matriz nao precisa
+// ser guardada, e um lote de b strings so calcula as sobreposicoes das novas
+// contra os F fragmentos e entre si, O(b (F + b)). As fusoes fracas tambem
+// nao viram pares: superstring () as refaz pelos prefixos e sufixos de menos
+// de min_overlap caracteres, sem calcular sobreposicoes e sem mexer no
+// estado. A contencao so parte do lote: um automato das novas, lido por
+// elas e pelos fragmentos, e um dos fragmentos mais curtos que a maior nova,
+// lido pelas novas. Com o estado vazio, um lote da o mesmo resultado de
+// --engine=sorted-edges --drop-contained; em varios lotes o resultado
+// depende da ordem deles. O arquivo de estado tem o formato da entrada: F e
+// os fragmentos.
+// ---------------------------------------------------------------------------
+
+// o caminho de links que comeca em nodes [i]; como remove_prefix,
+// sobreposicao do tamanho todo nao corta nada
+inline auto join_path (const Strings& nodes, const PathLinks& links, Size i) -> String
+{
+    String x = to_string (nodes [i]) ;
+    for (Size u = i; links.successor [u] >= 0; u = (Size) links.successor [u]) {
+        StringView next = nodes [(Size) links.successor [u]] ;
+        Size cut = links.joined [u] < next.length ? links.joined [u] : 0 ;
+        x.append (next.data + cut, next.length - cut) ;
+    }
+    return x ;
+}
+
+// todos os caminhos de links, na ordem das cabecas
+inline auto join_paths (const Strings& nodes, const PathLinks& links) -> std::vector <String>
+{
+    std::vector <String> paths ;
+    for (Size i = 0; i < size (nodes); ++i) if (! links.has_predecessor [i]) paths.push_back (join_path (nodes, links, i)) ;
+    // um caminho comeca pelo seu primeiro no, entao a ordem quase sempre
+    // ja e a dos nos
+    if (! std::is_sorted (paths.begin (), paths.end ())) std::sort (paths.begin (), paths.end ()) ;
+    return paths ;
+}
+
+// prefixo ou sufixo curto de um no, com o hash dele
+struct ShortKey
+{
+    StringView text ;
+    std::uint64_t hash ;
+} ;
+
+struct ShortKeyHash
+{
+    auto operator() (const ShortKey& k) const -> Size { return (Size) k.hash ; }
+} ;
+
+struct ShortKeyEqual
+{
+    auto operator() (const ShortKey& a, const ShortKey& b) const -> Boolean { return a.hash == b.hash && a.text == b.text ; }
+} ;
+
+// A varredura de sweep_sorted_edges so com as sobreposicoes menores que
+// below, sem gerar arestas: na classe k, a cauda livre u pega a menor
+// cabeca livre v de outro caminho com sufixo de k caracteres de u igual ao
+// prefixo de k caracteres de v, pela mesma fila de cabecas. Um par com
+// ov (u, v) > k tambem casa na classe k, mas se nao foi aceito na classe
+// dele e porque u ja tinha sucessor, v antecessor ou os dois estavam no
+// mesmo caminho, e nada disso se desfaz. Custa O(n below) e nao le pares.
+inline auto sweep_short_overlaps (const Strings& nodes, Size below) -> PathLinks
+{
+    Size n = size (nodes) ;
+    PathLinks links { std::vector <ll> (n, -1), std::vector <OverlapSize> (n, 0), std::vector <char> (n, 0) } ;
+    if (below < 2) return links ;
+    Size width = below - 1 ;
+
+    // hashes de Horner dos prefixos e sufixos de 1 a width caracteres: um
+    // sufixo e um prefixo iguais tem o mesmo hash
+    const std::uint64_t base = 0x100000001b3ull ;
+    std::vector <Size> start (n + 1, 0) ;
+    Size longest = 0 ;
+    for (Size i = 0; i < n; ++i) {
+        start [i + 1] = start [i] + std::min (width, nodes [i].length) ;
+        longest = std::max (longest, nodes [i].length) ;
+    }
+    std::vector <std::uint64_t> prefix (start [n]), suffix (start [n]) ;
+    for (Size i = 0; i < n; ++i) {
+        StringView x = nodes [i] ;
+        std::uint64_t h = 0, g = 0, power = 1 ;
+        for (Size k = 1; k <= start [i + 1] - start [i]; ++k) {
+            h = h * base + (unsigned char) x.data [k - 1] ;
+            g = g + power * (unsigned char) x.data [x.length - k] ;
+            power *= base ;
+            prefix [start [i] + k - 1] = h ;
+            suffix [start [i] + k - 1] = g ;
+        }
+    }
+
+    std::vector <Size> parent (n), head (n), tail (n) ;
+    for (Size i = 0; i < n; ++i) parent [i] = head [i] = tail [i] = i ;
+    using Heads = std::set <Size> ;
+    std::vector <Heads*> bucket (n, nullptr) ;
+    using Entry = Pair <Size, Size> ;
+    std::priority_queue <Entry, std::vector <Entry>, std::greater <Entry>> queue ;
+
+    for (Size k = std::min (width, longest); k >= 1; --k) {
+        std::unordered_map <ShortKey, Heads, ShortKeyHash, ShortKeyEqual> heads ;
+        for (Size v = 0; v < n; ++v) {
+            if (links.has_predecessor [v] || nodes [v].length < k) continue ;
+            heads [ShortKey { StringView { nodes [v].data, k }, prefix [start [v] + k - 1] }].insert (v) ;
+        }
+        // como em overlap_length, ov (u, v) < |u|
+        std::vector <Size> tails ;
+        for (Size u = 0; u < n; ++u) {
+            StringView x = nodes [u] ;
+            if (links.successor [u] >= 0 || x.length <= k) continue ;
+            auto it = heads.find (ShortKey { StringView { x.data + x.length - k, k }, suffix [start [u] + k - 1] }) ;
+            if (it == heads.end ()) continue ;
+            bucket [u] = &it->second ;
+            tails.push_back (u) ;
+            queue.push (Entry { head [find_root (parent, u)], u }) ;
+        }
+
+        while (! empty (queue)) {
+            Entry top = queue.top () ;
+            queue.pop () ;
+            Size u = top.second ;
+            Size a = find_root (parent, u) ;
+            if (links.successor [u] >= 0 || head [a] != top.first) continue ;
+            // a unica cabeca livre no caminho de u e head [a]
+            Heads& candidates = *bucket [u] ;
+            auto it = candidates.begin () ;
+            if (it != candidates.end () && find_root (parent, *it) == a) ++it ;
+            if (it == candidates.end ()) continue ;
+
+            Size v = *it ;
+            candidates.erase (it) ;
+            Size b = find_root (parent, v) ;
+            parent [b] = a ;
+            tail [a] = tail [b] ;
+            links.successor [u] = (ll) v ;
+            links.joined [u] = (OverlapSize) k ;
+            links.has_predecessor [v] = 1 ;
+            if (bucket [tail [a]]) queue.push (Entry { head [a], tail [a] }) ;
+        }
+        for (Size u : tails) bucket [u] = nullptr ;
+    }
+    return links ;
+}
+
+class OnlineSuperstring
+{
+public:
+    explicit OnlineSuperstring (Size min_overlap = online_min_overlap) : min_overlap (std::max <Size> (1, min_overlap)) {}
+
+    // devolve quantas strings do lote ja estavam dentro de um fragmento ou
+    // de outra string do lote
+    auto add (const Strings& batch) -> Size
+    {
+        Strings fresh = batch ;
+        sort_and_remove_repeated (fresh) ;
+
+        // uma nova igual a um fragmento ja esta nele
+        auto tstart = std::chrono::high_resolution_clock::now();
+        Size skipped = 0 ;
+        Strings added ;
+        for (StringView x : fresh) {
+            auto it = std::lower_bound (fragments.begin (), fragments.end (), x,
+                    [] (const String& f, StringView y) { return view (f) < y ; }) ;
+            if (it != fragments.end () && view (*it) == x) ++skipped ;
+            else added.push_back (x) ;
+        }
+
+        // como --drop-contained, mas a partir do lote: saem as novas dentro
+        // de outra nova ou de um fragmento, e os fragmentos dentro de uma
+        // nova, que so podem ser os mais curtos que ela
+        Strings old ;
+        for (const String& f : fragments) old.push_back (view (f)) ;
+        std::vector <char> inside = contained_strings (added, old) ;
+        Strings kept ;
+        Size longest = 0 ;
+        for (Size i = 0; i < size (added); ++i) {
+            if (inside [i]) {
+                ++skipped ;
+                continue ;
+            }
+            kept.push_back (added [i]) ;
+            longest = std::max (longest, added [i].length) ;
+        }
+        if (empty (kept)) {
+            add_paralel_time (Phase::input, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - tstart).count());
+            return skipped ;
+        }
+        Strings short_old ;
+        std::vector <Size> short_index ;
+        for (Size i = 0; i < size (old); ++i) {
+            if (old [i].length >= longest) continue ;
+            short_old.push_back (old [i]) ;
+            short_index.push_back (i) ;
+        }
+        std::vector <char> covered = contained_strings (short_old, kept) ;
+        std::vector <char> dropped (size (old), 0) ;
+        for (Size i = 0; i < size (short_index); ++i) dropped [short_index [i]] = covered [i] ;
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
+
+        // fragmentos e novas intercalados em ordem de conteudo, como os nos
+        // de sweep_sorted_edges; origin [i] e o fragmento do no i, ou -1
+        Strings nodes ;
+        std::vector <ll> origin ;
+        for (Size i = 0, j = 0; i < size (old) || j < size (kept); ) {
+            if (i < size (old) && dropped [i]) {
+                ++i ;
+            } else if (j == size (kept) || (i < size (old) && old [i] < kept [j])) {
+                nodes.push_back (old [i]) ;
+                origin.push_back ((ll) i++) ;
+            } else {
+                nodes.push_back (kept [j++]) ;
+                origin.push_back (-1) ;
+            }
+        }
+        std::vector <OverlapEdge> edges = overlap_edges (nodes, origin) ;
+
+        // so os caminhos que ganharam alguma coisa sao montados, todos antes
+        // de mover os fragmentos intactos, que ainda estao em nodes
+        tstart = std::chrono::high_resolution_clock::now();
+        PathLinks links = sweep_sorted_edges (size (nodes), edges) ;
+        std::vector <String> built (size (nodes)) ;
+        for (Size i = 0; i < size (nodes); ++i) {
+            if (links.has_predecessor [i] || (origin [i] >= 0 && links.successor [i] < 0)) continue ;
+            built [i] = join_path (nodes, links, i) ;
+        }
+        std::vector <String> next ;
+        for (Size i = 0; i < size (nodes); ++i) {
+            if (links.has_predecessor [i]) continue ;
+            if (origin [i] >= 0 && links.successor [i] < 0) next.push_back (std::move (fragments [(Size) origin [i]])) ;
+            else next.push_back (std::move (built [i])) ;
+        }
+        if (! std::is_sorted (next.begin (), next.end ())) std::sort (next.begin (), next.end ()) ;
+        fragments.swap (next) ;
+        tend = std::chrono::high_resolution_clock::now();
+        add_phase_time (Phase::merge, std::chrono::duration<double>(tend - tstart).count());
+        return skipped ;
+    }
+
+    // o resto da varredura (as fusoes abaixo de min_overlap) e os caminhos
+    // que sobram em ordem, como o laco original juntaria strings sem
+    // sobreposicao
+    auto superstring () const -> String
+    {
+        if (empty (fragments)) return "" ;
+        auto tstart = std::chrono::high_resolution_clock::now();
+        Strings nodes ;
+        for (const String& f : fragments) nodes.push_back (view (f)) ;
+        std::vector <String> paths = join_paths (nodes, sweep_short_overlaps (nodes, min_overlap)) ;
+        String x = paths [0] ;
+        for (Size i = 1; i < size (paths); ++i) {
+            // ov (x, p) < |p| + 1: basta o fim de x
+            Size m = std::min (size (x), size (paths [i]) + 1) ;
+            Size cut = overlap_value (StringView { x.data () + size (x) - m, m }, view (paths [i])) ;
+            x.append (paths [i], cut < size (paths [i]) ? cut : 0, String::npos) ;
+        }
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_phase_time (Phase::merge, std::chrono::duration<double>(tend - tstart).count());
+        return x ;
+    }
+
+    auto load (InStream& in) -> Boolean
+    {
+        Size n = 0 ;
+        if (! (in >> n)) return false ;
+        fragments.assign (n, String ()) ;
+        for (String& f : fragments) if (! (in >> f)) return false ;
+        if (! std::is_sorted (fragments.begin (), fragments.end ())) std::sort (fragments.begin (), fragments.end ()) ;
+        return true ;
+    }
+
+    auto save (OutStream& out) const -> Boolean
+    {
+        out << size (fragments) << '\n' ;
+        for (const String& f : fragments) out << f << '\n' ;
+        return (Boolean) out.flush () ;
+    }
+
+    auto fragment_count () const -> Size { return size (fragments) ; }
+
+private:
+    // arestas (i, j) com ov >= min_overlap, ja em ordem de edge_before; os
+    // pares entre dois fragmentos ficam de fora: a linha de cada nova cobre
+    // os pares entre novas, e a de um fragmento so passa pelas novas
+    auto overlap_edges (const Strings& nodes, const std::vector <ll>& origin) const -> std::vector <OverlapEdge>
+    {
+        Size n = size (nodes) ;
+        std::vector <Size> fresh ;
+        for (Size i = 0; i < n; ++i) if (origin [i] < 0) fresh.push_back (i) ;
+
+        auto tstart = std::chrono::high_resolution_clock::now();
+        std::vector <OverlapEdge> edges ;
+        #pragma omp parallel
+        {
+            ThreadClock clock ;
+            std::vector <OverlapEdge> local ;
+            auto edge = [&] (Size i, Size j) {
+                OverlapSize value = overlap_value (nodes [i], nodes [j]) ;
+                count_work (1, std::min (nodes [i].length, nodes [j].length)) ;
+                if (value >= min_overlap) local.push_back (OverlapEdge { value, (std::uint32_t) i, (std::uint32_t) j }) ;
+            } ;
+            #pragma omp for schedule(dynamic) nowait
+            for (ll x = 0; x < (ll) n; ++x) {
+                Size i = (Size) x ;
+                if (origin [i] >= 0) {
+                    for (Size j : fresh) edge (i, j) ;
+                } else {
+                    for (Size j = 0; j < n; ++j) if (j != i) edge (i, j) ;
+                }
+            }
+            clock.stop () ;
+            #pragma omp critical
+            edges.insert (edges.end (), local.begin (), local.end ()) ;
+        }
+        auto tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::overlaps, std::chrono::duration<double>(tend - tstart).count());
+
+        tstart = std::chrono::high_resolution_clock::now();
+        parallel_sort (edges, edge_before) ;
+        tend = std::chrono::high_resolution_clock::now();
+        add_paralel_time (Phase::pairs, std::chrono::duration<double>(tend - tstart).count());
+        return edges ;
+    }
+
+    Size min_overlap ;
+    std::vector <String> fragments ;
+} ;
+
+// ---------------------------------------------------------------------------
+// Kernel especializado em tempo de compilacao: com max_length != 0, ov (a, b)
+// entre duas strings de no maximo max_length caracteres testa k =
+// max_length - 1, ..., 1 por recursao de template, cada um com um memcmp de
+// tamanho constante, que o compilador desenrola por inteiro. Fusoes mais
+// longas voltam ao kernel geral da codificacao.
+// ---------------------------------------------------------------------------
+
+static const Size short_string_length = 8 ;
+
+template <Size k>
+struct FixedOverlap
+{
+    static auto of (const char* a, Size la, const char* b, Size lb) -> OverlapSize
+    {
+        if (k < la && k <= lb && std::memcmp (a + la - k, b, k) == 0) return k ;
+        return FixedOverlap <k - 1>::of (a, la, b, lb) ;
+    }
+} ;
+
+template <>
+struct FixedOverlap <0>
+{
+    static auto of (const char*, Size, const char*, Size) -> OverlapSize { return 0 ; }
+} ;
+
+template <Encoding encoding, Size max_length>
+struct FixedLengthOverlap
+{
+    const StringArena* arena ;
+
+    auto operator() (StringId a, StringId b) const -> OverlapSize
+    {
+        Size la = arena->lengths [a] ;
+        Size lb = arena->lengths [b] ;
+        count_work (1, std::min (la - (la > 0), lb)) ;
+        if (max_length != 0 && la <= max_length && lb <= max_length) {
+            const char* bytes = arena->bytes.data () ;
+            return FixedOverlap <max_length == 0 ? 0 : max_length - 1>::of
+                (bytes + arena->offsets [a], la, bytes + arena->offsets [b], lb) ;
+        }
+        if (encoding == Encoding::packed) return arena->packed_overlap (a, b) ;
+        return overlap_value ((*arena) [a], (*arena) [b]) ;
+    }
+} ;
+
+template <Encoding encoding, Size max_length> inline auto
+greedy_superstring (const Strings& t, const Options& options, std::vector <Merge>& merges) -> String
+{
+    if (empty (t)) return "" ;
+    std::vector <StringId> ss ;
+    StringArena arena = arena_from_strings (t, ss, encoding) ;
+    // alfabeto grande demais para empacotar: a arena fica so com os bytes
+    if (encoding == Encoding::packed && ! arena.packed ())
+        return greedy_merges (arena, ss, options, FixedLengthOverlap <Encoding::bytes, max_length> { &arena }, &merges) ;
+    return greedy_merges (arena, ss, options, FixedLengthOverlap <encoding, max_length> { &arena }, &merges) ;
+}
+
+// ---------------------------------------------------------------------------
+// API da biblioteca: solve_superstring recebe views (em qualquer ordem, com
+// repetidas) e devolve a superstring e a ordem das fusoes. Em merges, 0 ..
+// n - 1 sao as posicoes em t (a primeira, para repetidas) e a k-esima fusao
+// cria o fragmento n + k. So os motores gulosos (loop e incremental) fundem
+// pares; com exact, sorted-edges ou uma busca local que mude a resposta,
+// merges fica vazio. exhausted: o motor exato parou em options.exact_budget
+// sem provar o otimo. encoding e max_length escolhem o kernel do motor loop;
+// os outros motores seguem options.encoding.
+// ---------------------------------------------------------------------------
+
+struct Solution
+{
+    String superstring ;
+    std::vector <Merge> merges ;
+    Size contained = 0 ;
+    Boolean exhausted = false ;
+} ;
+
+// x: as strings distintas de t, ordenadas; origin [i]: a primeira posicao
+// de x [i] em t. Entrada ja ordenada e sem repetidas (a dos leitores) passa
+// direto.
+inline auto distinct_strings (const Strings& t, Strings& x, std::vector <Size>& origin) -> void
+{
+    Boolean sorted = true ;
+    for (Size i = 1; i < size (t) && sorted; ++i) sorted = t [i - 1] < t [i] ;
+    if (sorted) {
+        x = t ;
+        origin.resize (size (t)) ;
+        for (Size i = 0; i < size (t); ++i) origin [i] = i ;
+        return ;
+    }
+
+    auto tstart = std::chrono::high_resolution_clock::now();
+    std::vector <Pair <StringView, Size>> order ;
+    order.reserve (size (t)) ;
+    for (Size i = 0; i < size (t); ++i) order.push_back (Pair <StringView, Size> (t [i], i)) ;
+    parallel_sort (order, [] (const Pair <StringView, Size>& a, const Pair <StringView, Size>& b) {
+        int c = compare (a.first, b.first) ;
+        return c != 0 ? c < 0 : a.second < b.second ;
+    }) ;
+    x.clear () ;
+    origin.clear () ;
+    for (const Pair <StringView, Size>& e : order) {
+        if (! empty (x) && x.back () == e.first) continue ;
+        x.push_back (e.first) ;
+        origin.push_back (e.second) ;
+    }
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_paralel_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
+}
+
+template <Encoding encoding, Size max_length> auto
+solve_superstring (const Strings& t, const Options& options = Options ()) -> Solution
+{
+    Solution solution ;
+    Strings x ;
+    std::vector <Size> origin ;
+    distinct_strings (t, x, origin) ;
+    if (options.drop_contained) {
+        Strings all = x ;
+        solution.contained = drop_contained_strings (x) ;
+        std::vector <Size> kept ;
+        for (StringView s : x) kept.push_back (origin [(Size) (std::lower_bound (all.begin (), all.end (), s) - all.begin ())]) ;
+        origin.swap (kept) ;
+    }
+
+    std::vector <Merge> merges ;
+    if (options.engine == "incremental") solution.superstring = shortest_superstring_incremental (x, options, &merges) ;
+    else if (options.engine == "sorted-edges") solution.superstring = shortest_superstring_sorted_edges (x, options) ;
+    else if (options.engine == "exact") solution.superstring = shortest_superstring_exact (x, options, &solution.exhausted) ;
+    else solution.superstring = greedy_superstring <encoding, max_length> (x, options, merges) ;
+    if (options.local_search > 0.0) {
+        String better = improve_by_local_search (x, solution.superstring, options) ;
+        if (better != solution.superstring) merges.clear () ;
+        solution.superstring = better ;
+    }
+
+    // ids da arena: 0 .. size (x) - 1 sao as strings de x, depois as fusoes
+    auto position = [&] (Size id) { return id < size (x) ? origin [id] : size (t) + (id - size (x)) ; } ;
+    for (const Merge& m : merges) solution.merges.push_back (Merge { position (m.left), position (m.right), m.overlap }) ;
+    return solution ;
+}
+
+// instancia do template escolhida pela entrada: strings curtas (os
+// conjuntos de permutacoes) usam o kernel desenrolado
+inline auto solve_superstring (const Strings& t, const Options& options = Options ()) -> Solution
+{
+    Size longest = 0 ;
+    for (StringView s : t) longest = std::max (longest, s.length) ;
+    Boolean packed = options.encoding == Encoding::packed ;
+    if (longest <= short_string_length) {
+        if (packed) return solve_superstring <Encoding::packed, short_string_length> (t, options) ;
+        return solve_superstring <Encoding::bytes, short_string_length> (t, options) ;
+    }
+    if (packed) return solve_superstring <Encoding::packed, 0> (t, options) ;
+    return solve_superstring <Encoding::bytes, 0> (t, options) ;
+}
+
+// ---------------------------------------------------------------------------
+// Lote: o time do OpenMP e o heap sao reaproveitados entre instancias, e as
+// instancias pequenas demais para ocupar todas as threads sao resolvidas em
+// paralelo umas com as outras, cada uma com uma thread so.
+// ---------------------------------------------------------------------------
+
+static const Size small_instance_strings = 2000 ;
+
+inline auto solve_superstrings (const std::vector <Strings>& instances, const Options& options = Options ()) -> std::vector <Solution>
+{
+    std::vector <Solution> solutions (size (instances)) ;
+    std::vector <Size> small ;
+    for (Size k = 0; k < size (instances); ++k) {
+        if (size (instances [k]) < small_instance_strings) small.push_back (k) ;
+    }
+
+    // o tempo das regioes internas seria contado uma vez por thread; as
+    // fases continuam somadas por instancia
+    double before = profile ().paralel ;
+    auto tstart = std::chrono::high_resolution_clock::now();
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (ll k = 0; k < (ll) size (small); ++k) {
+        Size i = small [(Size) k] ;
+        solutions [i] = solve_superstring (instances [i], options) ;
+    }
+    auto tend = std::chrono::high_resolution_clock::now();
+    profile ().paralel = before + std::chrono::duration<double>(tend - tstart).count();
+
+    for (Size k = 0; k < size (instances); ++k) {
+        if (size (instances [k]) >= small_instance_strings) solutions [k] = solve_superstring (instances [k], options) ;
+    }
+    return solutions ;
+}
+
+#endif
@@ -1,257 +1,321 @@
+#include "shortest_superstring.hh"
 
-#include <algorithm>
-#include <iostream>
-#include <set>
-#include <string>
-#include <utility>
-#include <vector>
-#include <omp.h>
-#include <chrono>
+#include <cstdio>
+#include <fstream>
 
-using ll = long long;
-using OverlapSize = std::string::size_type;
-
-#define standard_input  std::cin
-#define standard_output std::cout
-
-using Boolean = bool ;
-using Size    = std::size_t ;
-using String  = std::string ;
-
-using InStream  = std::istream ;
-using OutStream = std::ostream ;
-
-template <typename T, typename U>
-using Pair = std::pair <T, U> ;
-
-template <typename T, typename C = std::less <T>>
-using Set = std::set <T> ;
-
-template <typename T>
-using SizeType = typename T :: size_type ;
-
-double global_paralel_time = 0.0;
-
-template <typename C> inline auto
-size (const C& x) -> SizeType <C> { 
-    return x.size (); 
-}
-
-template <typename C> inline auto
-at_least_two_elements_in (const C& c) -> Boolean 
-{ 
-    return size (c) > SizeType <C> (1); 
-}
-
-template <typename T> inline auto
-first_element (const Set <T>& x) -> T 
-{ 
-    return *(x.begin ()); 
-}
-
-template <typename T> inline auto
-second_element (const Set <T>& x) -> T 
-{ 
-    return *(std::next (x.begin ()));
- }
-
-template <typename T> inline auto
-remove (Set <T>& x, const T& e) -> Set <T>& 
-{ 
-    x.erase (e);
-    return x; 
-}
-
-template <typename T> inline auto
-push (Set <T>& x, const T& e) -> Set <T>& 
-{ 
-    x.insert (e); 
-    return x; 
-}
-
-template <typename C> inline auto
-empty (const C& x) -> Boolean 
-{ 
-    return x.empty (); 
-}
-
-Boolean is_prefix (const String& a, const String& b)
-{
-    if (size (a) > size (b)) return false;
-    if (! (std::mismatch(a.begin(), a.end(), b.begin()).first == a.end())) return false;
-    return true;
-}
-
-inline auto suffix_from_position (const String& x, SizeType <String> i) -> String 
+inline auto write_string_to_standard_ouput (const String& s) -> void 
 { 
-    return x.substr (i); 
-}
-
-inline auto remove_prefix (const String& x, SizeType <String> n) -> String
-{
-    if (size (x) > n) return suffix_from_position (x, n);
-    return x;
+    write_string_and_break_line (standard_output, s); 
 }
 
-auto all_suffixes (const String& x) -> Set <String>
+// numero de bytes com sufixo K, M ou G opcional
+auto parse_bytes (const String& x, Size& bytes) -> Boolean
 {
-    Set <String> ss;
-    SizeType <String> n = size (x);
-    while (--n) { ss.insert (x.substr (n)); }
-    return ss;
+    Size digits = x.find_first_not_of ("0123456789") ;
+    if (digits == 0 || digits == String::npos ? size (x) > 12 : digits > 12) return false ;
+    bytes = std::stoull (x.substr (0, digits)) ;
+    if (digits == String::npos) return true ;
+    if (digits + 1 != size (x)) return false ;
+    String units = "KMG" ;
+    Size unit = units.find (x [digits]) ;
+    if (unit == String::npos) return false ;
+    for (Size k = 0; k <= unit; ++k) bytes *= 1024 ;
+    return true ;
 }
 
-auto commom_suffix_and_prefix (const String& a, const String& b) -> String
+auto parse_options (int argc, char const* argv[], Options& options) -> Boolean
 {
-    if (empty (a) || empty (b)) return "";
-    String x = "";
-    for (const String& s : all_suffixes (a)) {
-        if (is_prefix (s, b) && size (s) > size (x)) x = s;
+    Boolean engine_given = false ;
+    Boolean min_overlap_given = false ;
+    Boolean exact_budget_given = false ;
+    for (int i = 1; i < argc; ++i) {
+        String arg = argv [i] ;
+        String value = arg.find ('=') == String::npos ? "" : arg.substr (arg.find ('=') + 1) ;
+        if (starts_with (arg, "--engine=")) {
+            engine_given = true ;
+            options.engine = value ;
+            if ( options.engine != "loop"
+                    && options.engine != "incremental"
+                    && options.engine != "sorted-edges"
+                    && options.engine != "exact" ) return false ;
+        } else if (arg == "--batch") {
+            options.batch = true ;
+        } else if (! starts_with (arg, "-")) {
+            options.files.push_back (arg) ;
+        } else if (starts_with (arg, "--state=")) {
+            options.state = value ;
+            if (empty (options.state)) return false ;
+        } else if (starts_with (arg, "--min-overlap=")) {
+            if (empty (value) || size (value) > 9 || value.find_first_not_of ("0123456789") != String::npos) return false ;
+            options.min_overlap = std::stoull (value) ;
+            min_overlap_given = true ;
+            if (options.min_overlap == 0) return false ;
+        } else if (arg == "--drop-contained") {
+            options.drop_contained = true ;
+        } else if (arg == "--encoding=bytes" || arg == "--encoding=packed") {
+            options.encoding = value == "packed" ? Encoding::packed : Encoding::bytes ;
+        } else if (arg == "--overlaps=pairwise" || arg == "--overlaps=aho-corasick") {
+            options.overlaps = value == "aho-corasick" ? OverlapStage::automaton : OverlapStage::pairwise ;
+        } else if (arg == "--reader=stream" || arg == "--reader=mmap" || arg == "--reader=pipeline") {
+            options.reader = value == "mmap" ? Reader::mapped : (value == "pipeline" ? Reader::pipelined : Reader::stream) ;
+        } else if (arg == "--profile=json" || arg == "--profile=csv") {
+            options.report = value == "json" ? Report::json : Report::csv ;
+        } else if (arg == "--scheduler=omp" || arg == "--scheduler=steal") {
+            options.scheduler = value == "steal" ? Scheduler::stealing : Scheduler::worksharing ;
+        } else if (starts_with (arg, "--max-mem=")) {
+            if (! parse_bytes (value, options.max_memory)) return false ;
+        } else if (starts_with (arg, "--seed=")) {
+            if (empty (value) || size (value) > 4 || value.find_first_not_of ("0123456789") != String::npos) return false ;
+            options.seed = std::stoull (value) ;
+            if (options.seed == 0) return false ;
+        } else if (starts_with (arg, "--local-search=")) {
+            char* end = nullptr ;
+            options.local_search = std::strtod (value.c_str (), &end) ;
+            if (empty (value) || *end != '\0' || ! (options.local_search > 0.0)) return false ;
+        } else if (starts_with (arg, "--exact-budget=")) {
+            char* end = nullptr ;
+            options.exact_budget = std::strtod (value.c_str (), &end) ;
+            exact_budget_given = true ;
+            if (empty (value) || *end != '\0' || ! (options.exact_budget > 0.0)) return false ;
+        } else if (arg == "--tile=auto") {
+            options.tile = auto_tile ;
+        } else if (starts_with (arg, "--tile=")) {
+            if (empty (value) || size (value) > 9 || value.find_first_not_of ("0123456789") != String::npos) return false ;
+            options.tile = std::stoull (value) ;
+        } else {
+            return false ;
+        }
     }
-    return x;
-}
-
-inline auto overlap_value (const String& s, const String& t) -> SizeType <String>
-{
-    return size (commom_suffix_and_prefix (s, t));
+    // so os motores com matriz usam o automato, so o incremental usa
+    // sementes, so o exato tem prazo; arquivos so no modo lote; o modo online e sempre o guloso
+    // de arestas ordenadas sobre uma instancia so (outro --engine e erro);
+    // o pipeline monta so a matriz densa do incremental, em bytes, com
+    // --scheduler e --tile, sem pre-filtro, sementes, --max-mem ou busca
+    // local
+    return (options.overlaps == OverlapStage::pairwise || options.engine != "loop")
+        && (options.seed == 0 || options.engine == "incremental")
+        && (! exact_budget_given || options.engine == "exact")
+        && (options.batch || empty (options.files))
+        && (! min_overlap_given || ! empty (options.state))
+        && ( empty (options.state)
+                || ( ! options.batch && options.local_search == 0.0
+                    && (! engine_given || options.engine == "sorted-edges") ) )
+        && ( options.reader != Reader::pipelined
+                || ( options.engine == "incremental" && ! options.batch && empty (options.state)
+                    && ! options.drop_contained && options.local_search == 0.0
+                    && options.seed == 0 && options.max_memory == 0
+                    && options.encoding == Encoding::bytes && options.overlaps == OverlapStage::pairwise ) ) ;
 }
 
-auto overlap (const String& s, const String& t) -> String
+inline auto write_usage (OutStream& out, char const* program) -> void
 {
-    String c = commom_suffix_and_prefix (s, t);
-    return s + remove_prefix (t, size (c));
+    out << "uso: " << program << " [--engine=loop|incremental|sorted-edges|exact [--overlaps=pairwise|aho-corasick] [--seed=k] [--exact-budget=segundos]]"
+        << " [--encoding=bytes|packed] [--scheduler=omp|steal] [--tile=B|auto] [--max-mem=N[K|M|G]]"
+        << " [--local-search=segundos] [--profile=json|csv]"
+        << " [--reader=stream|mmap|pipeline] [--drop-contained] < entrada" << std::endl ;
+    out << "     " << program << " --batch [opcoes] [arquivo ...]" << std::endl ;
+    out << "     " << program << " --reader=pipeline --engine=incremental [--scheduler=omp|steal] [--tile=B|auto] [--profile=json|csv] < entrada" << std::endl ;
+    out << "     " << program << " --state=arquivo [--min-overlap=k] [opcoes] < lote"
+        << "   (sempre --engine=sorted-edges)" << std::endl ;
 }
 
-inline auto pop_two_elements_and_push_overlap (Set <String>& ss, const Pair <String, String>& p) -> Set <String>&
-{
-    ss = remove (ss, p.first);
-    ss = remove (ss, p.second);
-    ss = push   (ss, overlap (p.first, p.second));
-    return ss;
-}
+// ---------------------------------------------------------------------------
+// Modo online: o estado e lido de --state (se existir), recebe o lote da
+// entrada e e gravado de volta por um arquivo temporario e rename, para que
+// uma falha no meio nao perca o estado anterior.
+// ---------------------------------------------------------------------------
 
-auto all_distinct_pairs (const std::vector<String>& ss) -> std::vector<Pair<String,String>>
+auto run_online (const Options& options, const Strings& batch, Size& contained) -> Boolean
 {
-    ll size = ss.size();
+    OnlineSuperstring online (options.min_overlap) ;
     auto tstart = std::chrono::high_resolution_clock::now();
+    std::ifstream in (options.state) ;
+    if (in && ! online.load (in)) {
+        std::cerr << "erro lendo " << options.state << std::endl ;
+        return false ;
+    }
+    auto tend = std::chrono::high_resolution_clock::now();
+    add_phase_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
 
-    std::vector<Pair<String,String>> pairs;
-    pairs.reserve(size * (size - 1));
+    contained = online.add (batch) ;
 
-    #pragma omp parallel for
-    for (ll i = 0; i < size; i++) {
-        for (ll j = 0; j < (int)size; j++) {
-            if (i == j) continue;
-            #pragma omp critical
-            pairs.emplace_back(ss[i], ss[j]);
-        }
+    if (! is_root_rank ()) return true ;
+    String temporary = options.state + ".tmp" ;
+    std::ofstream out (temporary) ;
+    if (! out || ! online.save (out) || (out.close (), std::rename (temporary.c_str (), options.state.c_str ()) != 0)) {
+        std::cerr << "erro gravando " << options.state << std::endl ;
+        return false ;
     }
-
-    auto tend = std::chrono::high_resolution_clock::now();
-    global_paralel_time += std::chrono::duration<double>(tend - tstart).count();
-    return pairs;
+    write_string_to_standard_ouput (online.superstring ()) ;
+    return true ;
 }
 
-static inline bool lex_compare(const Pair<String,String>& a, const Pair<String,String>& b) {
-    return (a.first < b.first) || (a.first == b.first && a.second < b.second);
+// ---------------------------------------------------------------------------
+// Modo lote: varias instancias (n e n palavras, repetido ate o fim) na
+// entrada padrao ou em arquivos, uma superstring por linha na saida.
+// ---------------------------------------------------------------------------
+
+// falso se sobrar algo que nao comeca com o numero de strings
+auto read_instances (const InputBuffer& in, std::vector <Strings>& instances) -> Boolean
+{
+    const char* p = in.data ;
+    const char* end = in.data + in.length ;
+    for (;;) {
+        while (p != end && is_space (*p)) ++p ;
+        if (p == end) return true ;
+        if (*p < '0' || *p > '9') return false ;
+        instances.push_back (parse_strings (p, end)) ;
+        sort_and_remove_repeated (instances.back ()) ;
+    }
 }
 
-static auto highest_overlap_value(const std::vector<Pair<String,String>>& v) -> Pair<String,String> {
-    Pair<String,String> best_pair = v[0];
-    OverlapSize best_overlap = overlap_value(best_pair.first, best_pair.second);
+auto run_batch (const Options& options, Size& contained, Size& exhausted) -> Boolean
+{
+    std::vector <std::unique_ptr <InputBuffer>> buffers ;
+    std::vector <Strings> instances ;
     auto tstart = std::chrono::high_resolution_clock::now();
-
-    #pragma omp parallel
-    {
-        Pair<String,String> local_pair = best_pair;
-        OverlapSize local_overlap = best_overlap;
-
-        #pragma omp for schedule(dynamic)
-        for (ll i = 0; i < (ll)v.size(); ++i) {
-            const auto& cand = v[(size_t)i];
-            auto ovrlp = overlap_value(cand.first, cand.second);
-            if (ovrlp > local_overlap || (ovrlp == local_overlap && lex_compare(cand, local_pair))) {
-                local_overlap = ovrlp;
-                local_pair = cand;
-            }
+    if (empty (options.files)) {
+        buffers.emplace_back (new InputBuffer) ;
+        if (! load_standard_input (*buffers.back ()) || ! read_instances (*buffers.back (), instances)) {
+            std::cerr << "erro lendo a entrada padrao" << std::endl ;
+            return false ;
         }
-
-        #pragma omp critical
-        {
-            if (local_overlap > best_overlap || (local_overlap == best_overlap && lex_compare(local_pair, best_pair))) {
-                best_overlap = local_overlap;
-                best_pair = local_pair;
-            }
+    }
+    for (const String& file : options.files) {
+        int fd = open (file.c_str (), O_RDONLY) ;
+        buffers.emplace_back (new InputBuffer) ;
+        Boolean loaded = fd >= 0 && buffers.back ()->load (fd) ;
+        if (fd >= 0) close (fd) ;
+        if (! loaded || ! read_instances (*buffers.back (), instances)) {
+            std::cerr << "erro lendo " << file << std::endl ;
+            return false ;
         }
     }
-
     auto tend = std::chrono::high_resolution_clock::now();
-    global_paralel_time += std::chrono::duration<double>(tend - tstart).count();
-    return best_pair;
-}
-
-auto pair_of_strings_with_highest_overlap_value (const Set <String>& ss) -> Pair <String, String>
-{
-    std::vector<String> v(ss.begin(), ss.end());
+    add_phase_time (Phase::input, std::chrono::duration<double>(tend - tstart).count());
 
-    if (v.size () < 2) return v.empty() ? Pair<String,String>{"",""} : Pair<String,String>{v[0], v[0]};
+    std::vector <Solution> solutions = solve_superstrings (instances, options) ;
 
-    return highest_overlap_value(all_distinct_pairs(v)); 
-}
-
-auto
-shortest_superstring (Set <String> t) -> String
-{
-    if (empty (t)) return "" ;
-    while (at_least_two_elements_in (t)) {
-        t = pop_two_elements_and_push_overlap
-            ( t
-            , pair_of_strings_with_highest_overlap_value (t) ) ;
+    contained = 0 ;
+    exhausted = 0 ;
+    for (const Solution& solution : solutions) {
+        if (is_root_rank ()) standard_output << solution.superstring << '\n' ;
+        contained += solution.contained ;
+        exhausted += solution.exhausted ;
     }
-    return first_element (t) ;
+    standard_output.flush () ;
+    return true ;
 }
 
-inline auto write_string_and_break_line (OutStream& out, String s) -> void 
-{ 
-    out << s << std::endl; 
-}
+// ---------------------------------------------------------------------------
+// Relatorio de --profile, em stderr depois do trio "total paralelo
+// fracao_sequencial". CSV em formato longo: metrica,chave,valor.
+// ---------------------------------------------------------------------------
 
-inline auto read_size (InStream& in) -> Size 
-{ 
-    Size n; 
-    in >> n; 
-    return n; 
-}
-
-inline auto read_string (InStream& in) -> String { 
-    String s; 
-    in >> s; 
-    return s; 
-}
-
-auto read_strings_from_standard_input () -> Set <String>
+auto write_profile_json (OutStream& out, double total) -> void
 {
-    using N = SizeType <Set <String>>;
-    Set <String> x;
-    N n = N (read_size (standard_input));
-    while (n--) x.insert (read_string (standard_input));
-    return x;
+    out << "{\"total\":" << total << ",\"paralel\":" << profile ().paralel
+        << ",\"seq_frac\":" << 1.0 - profile ().paralel / total << ",\"phases\":{" ;
+    for (Size k = 0; k < phase_count; ++k)
+        out << (k ? "," : "") << "\"" << phase_names [k] << "\":" << profile ().phases [k] ;
+    out << "},\"threads\":[" ;
+    for (Size k = 0; k < size (profile ().threads); ++k) {
+        const ThreadCounters& c = profile ().threads [k] ;
+        out << (k ? "," : "") << "{\"thread\":" << k << ",\"pairs\":" << c.pairs
+            << ",\"comparisons\":" << c.comparisons << ",\"allocations\":" << c.allocations
+            << ",\"busy\":" << c.busy << ",\"idle\":" << c.idle << "}" ;
+    }
+    out << "],\"iterations\":[" ;
+    for (Size k = 0; k < size (profile ().iterations); ++k) out << (k ? "," : "") << profile ().iterations [k] ;
+    out << "]}\n" ;
 }
 
-inline auto write_string_to_standard_ouput (const String& s) -> void 
-{ 
-    write_string_and_break_line (standard_output, s); 
+auto write_profile_csv (OutStream& out, double total) -> void
+{
+    out << "metric,key,value\n" ;
+    out << "total,," << total << "\n" ;
+    out << "paralel,," << profile ().paralel << "\n" ;
+    out << "seq_frac,," << 1.0 - profile ().paralel / total << "\n" ;
+    for (Size k = 0; k < phase_count; ++k) out << "phase," << phase_names [k] << "," << profile ().phases [k] << "\n" ;
+    for (Size k = 0; k < size (profile ().threads); ++k) {
+        const ThreadCounters& c = profile ().threads [k] ;
+        out << "pairs," << k << "," << c.pairs << "\n" ;
+        out << "comparisons," << k << "," << c.comparisons << "\n" ;
+        out << "allocations," << k << "," << c.allocations << "\n" ;
+        out << "busy," << k << "," << c.busy << "\n" ;
+        out << "idle," << k << "," << c.idle << "\n" ;
+    }
+    for (Size k = 0; k < size (profile ().iterations); ++k) out << "iteration," << k << "," << profile ().iterations [k] << "\n" ;
 }
 
-auto main () -> int
+auto run (const Options& options) -> int
 {
+    if (options.report != Report::none) start_profile () ;
     auto start = std::chrono::high_resolution_clock::now();
-    Set <String> ss = read_strings_from_standard_input ();
-    write_string_to_standard_ouput (shortest_superstring (ss));
+    Size contained = 0 ;
+    Size exhausted = 0 ;
+    Set <String> set ;
+    InputBuffer buffer ;
+    Strings ss ;
+    // batch e pipeline resolvem enquanto leem
+    Boolean solved = options.batch || options.reader == Reader::pipelined ;
+    if (options.batch) {
+        if (! run_batch (options, contained, exhausted)) return 1 ;
+    } else if (options.reader == Reader::pipelined) {
+        String x ;
+        if (! shortest_superstring_pipelined (0, options, x)) {
+            std::cerr << "erro lendo a entrada padrao" << std::endl ;
+            return 1 ;
+        }
+        write_string_to_standard_ouput (x) ;
+    } else if (options.reader == Reader::mapped) {
+        if (! load_standard_input (buffer)) {
+            std::cerr << "erro lendo a entrada padrao" << std::endl ;
+            return 1 ;
+        }
+        ss = read_strings_from_buffer (buffer) ;
+    } else {
+        set = read_strings_from_standard_input () ;
+        ss = views_of (set) ;
+    }
+    if (! solved) add_phase_time (Phase::input, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+    if (! empty (options.state)) {
+        if (! run_online (options, ss, contained)) return 1 ;
+    } else if (! solved) {
+        Solution solution = solve_superstring (ss, options) ;
+        contained = solution.contained ;
+        exhausted = solution.exhausted ;
+        if (is_root_rank ()) write_string_to_standard_ouput (solution.superstring);
+    }
     auto end = std::chrono::high_resolution_clock::now();
 
     double total = std::chrono::duration<double>(end - start).count();
 
-    std::cerr << total << " " << global_paralel_time << " " << 1.0 - (global_paralel_time / total) << "\n";
+    if (! is_root_rank ()) return 0 ;
+    std::cerr << total << " " << profile ().paralel << " " << 1.0 - (profile ().paralel / total) << "\n";
+    if (options.drop_contained) std::cerr << "strings contidas removidas: " << contained << "\n";
+    if (exhausted > 0)
+        std::cerr << "exact: prazo de " << options.exact_budget << " s esgotado em " << exhausted
+            << " instancia(s); fica o melhor caminho achado, sem prova de otimo\n";
+    if (options.report == Report::json) write_profile_json (std::cerr, total) ;
+    if (options.report == Report::csv) write_profile_csv (std::cerr, total) ;
     return 0;
-}
\ No newline at end of file
+}
+
+auto main (int argc, char const* argv[]) -> int
+{
+    start_ranks () ;
+    Options options ;
+    int status = 1 ;
+    if (parse_options (argc, argv, options)) {
+#ifdef SHSUP_MPI
+        // so o processo 0 tem a entrada padrao
+        options.reader = Reader::mapped ;
+#endif
+        status = run (options) ;
+    } else if (is_root_rank ()) {
+        write_usage (std::cerr, argv [0]) ;
+    }
+    stop_ranks () ;
+    return status ;
+}